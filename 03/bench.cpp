@@ -0,0 +1,214 @@
+#include "token_parser.h"
+#include "token_range.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+static size_t g_allocations = 0;
+static volatile uint64_t g_sink = 0;
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct CorpusSpec {
+    const char* name;
+    double number_ratio;
+    size_t min_length;
+    size_t max_length;
+    bool mixed_whitespace;
+    bool huge_numbers;
+    size_t vocabulary;
+};
+
+struct Result {
+    double seconds;
+    size_t tokens;
+    size_t allocations;
+};
+
+static const size_t kCorpusBytes = 8 * 1024 * 1024;
+static const int kRepeats = 3;
+
+static std::string GenerateCorpus(const CorpusSpec& spec) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<size_t> length(spec.min_length, spec.max_length);
+    std::uniform_int_distribution<int> digit('0', '9');
+    std::uniform_int_distribution<int> letter('a', 'z');
+    static const char spaces[] = " \t\n\r";
+
+    std::vector<std::string> words(spec.vocabulary);
+    for (std::string& word : words) {
+        size_t n = length(rng);
+        for (size_t i = 0; i < n; ++i) word += static_cast<char>(letter(rng));
+    }
+
+    std::string text;
+    text.reserve(kCorpusBytes + 64);
+    while (text.size() < kCorpusBytes) {
+        if (coin(rng) < spec.number_ratio) {
+            size_t n = spec.huge_numbers ? 25 : std::min<size_t>(length(rng), 19);
+            for (size_t i = 0; i < n; ++i) text += static_cast<char>(digit(rng));
+        } else if (!words.empty()) {
+            text += words[rng() % words.size()];
+        } else {
+            size_t n = length(rng);
+            for (size_t i = 0; i < n; ++i) text += static_cast<char>(letter(rng));
+        }
+        if (spec.mixed_whitespace) {
+            size_t n = 1 + rng() % 4;
+            for (size_t i = 0; i < n; ++i) text += spaces[rng() % 4];
+        } else
+            text += ' ';
+    }
+    return text;
+}
+
+template<class Fn>
+static Result Measure(Fn&& run) {
+    Result best{1e100, 0, 0};
+    for (int r = 0; r < kRepeats; ++r) {
+        size_t allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        size_t tokens = run();
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        if (seconds < best.seconds) best = Result{seconds, tokens, g_allocations - allocations};
+    }
+    return best;
+}
+
+static void Report(const char* corpus, const char* mode, size_t bytes, const Result& result) {
+    double mb = bytes / (1024.0 * 1024.0);
+    std::printf("%-14s %-22s %10.1f %12.2f %12.3f\n", corpus, mode,
+                mb / result.seconds, result.tokens / result.seconds / 1e6,
+                result.tokens ? static_cast<double>(result.allocations) / result.tokens : 0.0);
+}
+
+static void RunCorpus(const CorpusSpec& spec) {
+    std::string text = GenerateCorpus(spec);
+    std::string path = std::string("/tmp/token_parser_bench_") + spec.name + ".txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    Report(spec.name, "std::function/string", text.size(), Measure([&text]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        TokenParser parser;
+        parser.SetDigitTokenCallback([&](uint64_t num) { sum += num; ++tokens; });
+        parser.SetStringTokenCallback([&](const std::string& str) { sum += str.size(); ++tokens; });
+        parser.Parse(text);
+        g_sink = sum;
+        return tokens;
+    }));
+
+    Report(spec.name, "std::function/view", text.size(), Measure([&text]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        TokenParser parser;
+        parser.SetDigitTokenCallback([&](uint64_t num) { sum += num; ++tokens; });
+        parser.SetStringViewTokenCallback([&](std::string_view str) { sum += str.size(); ++tokens; });
+        parser.Parse(text);
+        g_sink = sum;
+        return tokens;
+    }));
+
+    Report(spec.name, "BasicTokenParser", text.size(), Measure([&text]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        BasicTokenParser parser(
+            [&](uint64_t num) { sum += num; ++tokens; },
+            [&](std::string_view str) { sum += str.size(); ++tokens; });
+        parser.Parse(text);
+        g_sink = sum;
+        return tokens;
+    }));
+
+    Report(spec.name, "ParseFile (mmap)", text.size(), Measure([&path]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        BasicTokenParser parser(
+            [&](uint64_t num) { sum += num; ++tokens; },
+            [&](std::string_view str) { sum += str.size(); ++tokens; });
+        parser.ParseFile(path);
+        g_sink = sum;
+        return tokens;
+    }));
+
+    std::vector<uint64_t> numbers(kTokenBatchSize);
+    std::vector<size_t> offsets(kTokenBatchSize);
+    std::vector<size_t> lengths(kTokenBatchSize);
+    std::vector<TokenKind> kinds(kTokenBatchSize);
+    TokenBatchBuffer buffer{numbers.data(), offsets.data(), lengths.data(), kinds.data(), kTokenBatchSize};
+    Report(spec.name, "ParseBatched", text.size(), Measure([&text, &buffer]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        ParseBatched(text, buffer, [&](const TokenBatch& batch) {
+            for (size_t i = 0; i < batch.number_count; ++i) sum += batch.numbers[i];
+            for (size_t i = 0; i < batch.string_count; ++i) sum += batch.lengths[i];
+            tokens += batch.size;
+        });
+        g_sink = sum;
+        return tokens;
+    }));
+
+    Report(spec.name, "tokens() range", text.size(), Measure([&text]() {
+        size_t tokens_count = 0;
+        uint64_t sum = 0;
+        for (const Token& token : tokens(text)) {
+            if (const uint64_t* num = std::get_if<uint64_t>(&token)) sum += *num;
+            else sum += std::get<std::string_view>(token).size();
+            ++tokens_count;
+        }
+        g_sink = sum;
+        return tokens_count;
+    }));
+
+    Report(spec.name, "interning", text.size(), Measure([&text]() {
+        size_t tokens = 0;
+        uint64_t sum = 0;
+        TokenParser parser;
+        parser.SetDigitTokenCallback([&](uint64_t num) { sum += num; ++tokens; });
+        parser.SetStringIdCallback([&](uint32_t id) { sum += id; ++tokens; });
+        parser.Parse(text);
+        g_sink = sum;
+        return tokens;
+    }));
+
+    std::remove(path.c_str());
+}
+
+int main() {
+    static const CorpusSpec corpora[] = {
+        {"words", 0.0, 3, 10, false, false, 0},
+        {"vocab-1k", 0.1, 3, 10, false, false, 1000},
+        {"numbers", 1.0, 1, 19, false, false, 0},
+        {"mixed", 0.5, 3, 10, false, false, 0},
+        {"mixed-ws", 0.5, 3, 10, true, false, 0},
+        {"long-tokens", 0.5, 32, 64, false, false, 0},
+        {"huge-numbers", 0.9, 3, 10, false, true, 0},
+    };
+
+    std::printf("%-14s %-22s %10s %12s %12s\n", "corpus", "mode", "MB/s", "Mtokens/s", "allocs/tok");
+    for (const CorpusSpec& spec : corpora)
+        RunCorpus(spec);
+    return 0;
+}
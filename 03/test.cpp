@@ -1,8 +1,14 @@
 #include "token_parser.h" 
+#include "token_range.h"
 #include <gtest/gtest.h>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <fstream>
+#include <system_error>
+#include <ranges>
+#include <variant>
 
 class TokenParserTest : public ::testing::Test {
 protected:
@@ -181,6 +187,315 @@ TEST_F(TokenParserTest, CallbackOrder) {
     EXPECT_EQ(callback_order[4], "string:third");
 }
 
+TEST_F(TokenParserTest, ParseFile) {
+    std::string path = ::testing::TempDir() + "token_parser_parse_file.txt";
+    {
+        std::ofstream out(path);
+        out << "first 123\nsecond\t456 third";
+    }
+
+    std::vector<std::string> views;
+    parser.SetStringViewTokenCallback([&views](std::string_view str) {
+        views.emplace_back(str);
+    });
+    parser.ParseFile(path);
+
+    EXPECT_EQ(digit_tokens.size(), 2);
+    EXPECT_EQ(digit_tokens[0], 123);
+    EXPECT_EQ(digit_tokens[1], 456);
+    EXPECT_TRUE(string_tokens.empty());
+    ASSERT_EQ(views.size(), 3);
+    EXPECT_EQ(views[2], "third");
+}
+
+TEST_F(TokenParserTest, ParseEmptyFile) {
+    std::string path = ::testing::TempDir() + "token_parser_empty_file.txt";
+    std::ofstream(path).close();
+
+    parser.ParseFile(path);
+    EXPECT_TRUE(digit_tokens.empty());
+    EXPECT_TRUE(string_tokens.empty());
+}
+
+TEST_F(TokenParserTest, ParseMissingFile) {
+    EXPECT_THROW(parser.ParseFile("/nonexistent/token_parser_input.txt"), std::system_error);
+}
+
+TEST_F(TokenParserTest, CustomDelimiters) {
+    parser.SetDelimiters(",|\t");
+    parser.Parse("a,1||b\t22 c,");
+    EXPECT_EQ(digit_tokens, (std::vector<uint64_t>{1}));
+    EXPECT_EQ(string_tokens, (std::vector<std::string>{"a", "b", "22 c"}));
+}
+
+TEST_F(TokenParserTest, TypedNumberCallbacks) {
+    std::vector<int64_t> signed_tokens;
+    std::vector<uint64_t> hex_tokens;
+    std::vector<double> double_tokens;
+    parser.SetSignedTokenCallback([&signed_tokens](int64_t num) { signed_tokens.push_back(num); });
+    parser.SetHexTokenCallback([&hex_tokens](uint64_t num) { hex_tokens.push_back(num); });
+    parser.SetDoubleTokenCallback([&double_tokens](double num) { double_tokens.push_back(num); });
+
+    parser.Parse("12 -7 +8 0x1F 0XfF 3.5 -.25 1e3 inf nan 0x 0xZZ -9223372036854775809 abc");
+
+    EXPECT_EQ(digit_tokens, (std::vector<uint64_t>{12}));
+    EXPECT_EQ(signed_tokens, (std::vector<int64_t>{-7, 8}));
+    EXPECT_EQ(hex_tokens, (std::vector<uint64_t>{0x1F, 0xFF}));
+    EXPECT_EQ(double_tokens, (std::vector<double>{3.5, -0.25, 1000.0, -9223372036854775809.0}));
+    EXPECT_EQ(string_tokens, (std::vector<std::string>{"inf", "nan", "0x", "0xZZ", "abc"}));
+}
+
+TEST_F(TokenParserTest, TypedCallbacksUnsetFallBackToString) {
+    parser.Parse("-7 0x1F 3.5");
+    EXPECT_TRUE(digit_tokens.empty());
+    EXPECT_EQ(string_tokens, (std::vector<std::string>{"-7", "0x1F", "3.5"}));
+}
+
+TEST(BasicTokenParserTest, ClassTableAndTypedCallbacks) {
+    constexpr CharClassTable csv = CharClassTable::Delimiters(",\n");
+    static_assert(csv.IsDelimiter(','));
+    static_assert(!csv.IsDelimiter(' '));
+
+    std::vector<uint64_t> digits;
+    std::vector<int64_t> signed_numbers;
+    std::vector<double> doubles;
+    std::vector<std::string_view> strings;
+
+    BasicTokenParser parser(
+        csv,
+        [&digits](uint64_t num) { digits.push_back(num); },
+        [&strings](std::string_view str) { strings.push_back(str); },
+        [&signed_numbers](int64_t num) { signed_numbers.push_back(num); },
+        nullptr,
+        [&doubles](double num) { doubles.push_back(num); });
+    parser.Parse("1,-2,0x3,4.5\nhello world");
+
+    EXPECT_EQ(digits, (std::vector<uint64_t>{1}));
+    EXPECT_EQ(signed_numbers, (std::vector<int64_t>{-2}));
+    EXPECT_EQ(doubles, (std::vector<double>{4.5}));
+    EXPECT_EQ(strings, (std::vector<std::string_view>{"0x3", "hello world"}));
+}
+
+TEST(BasicTokenParserTest, SingleSignOnly) {
+    std::vector<int64_t> signed_numbers;
+    std::vector<double> doubles;
+    std::vector<std::string_view> strings;
+
+    BasicTokenParser parser(
+        nullptr,
+        [&strings](std::string_view str) { strings.push_back(str); },
+        [&signed_numbers](int64_t num) { signed_numbers.push_back(num); },
+        nullptr,
+        [&doubles](double num) { doubles.push_back(num); });
+    parser.Parse("+5 -5 +-5 -+5 + - +1.5 -1.5 +-1.5 -+1.5 ++5 --5");
+
+    EXPECT_EQ(signed_numbers, (std::vector<int64_t>{5, -5}));
+    EXPECT_EQ(doubles, (std::vector<double>{1.5, -1.5}));
+    EXPECT_EQ(strings, (std::vector<std::string_view>{"+-5", "-+5", "+", "-", "+-1.5", "-+1.5", "++5", "--5"}));
+}
+
+TEST(BasicTokenParserTest, InlineCallbacks) {
+    std::vector<uint64_t> digits;
+    std::vector<std::string_view> strings;
+
+    BasicTokenParser parser(
+        [&digits](uint64_t num) { digits.push_back(num); },
+        [&strings](std::string_view str) { strings.push_back(str); });
+
+    std::string text = "first 123 second 456 99999999999999999999999";
+    parser.Parse(text);
+
+    ASSERT_EQ(digits.size(), 2);
+    EXPECT_EQ(digits[0], 123);
+    EXPECT_EQ(digits[1], 456);
+    ASSERT_EQ(strings.size(), 3);
+    EXPECT_EQ(strings[0], "first");
+    EXPECT_EQ(strings[1], "second");
+    EXPECT_EQ(strings[2], "99999999999999999999999");
+    EXPECT_EQ(strings[0].data(), text.data());
+}
+
+TEST(BasicTokenParserTest, StdStringCallback) {
+    std::vector<std::string> strings;
+
+    BasicTokenParser parser(
+        [](uint64_t) {},
+        [&strings](const std::string& str) { strings.push_back(str); });
+    parser.Parse("hello 1 world");
+
+    ASSERT_EQ(strings.size(), 2);
+    EXPECT_EQ(strings[0], "hello");
+    EXPECT_EQ(strings[1], "world");
+}
+
+TEST(BasicTokenParserTest, NoDigitCallbackFallsBackToString) {
+    std::vector<std::string_view> strings;
+
+    BasicTokenParser parser(nullptr, [&strings](std::string_view str) { strings.push_back(str); });
+    parser.Parse("hello 123");
+
+    ASSERT_EQ(strings.size(), 2);
+    EXPECT_EQ(strings[1], "123");
+}
+
+TEST(TokenBatchTest, ColumnarBatches) {
+    constexpr size_t capacity = 3;
+    uint64_t numbers[capacity];
+    size_t offsets[capacity];
+    size_t lengths[capacity];
+    TokenKind kinds[capacity];
+    TokenBatchBuffer buffer{numbers, offsets, lengths, kinds, capacity};
+
+    std::string text = "first 123 second 456 third 789 fourth";
+    std::vector<uint64_t> all_numbers;
+    std::vector<std::string> all_strings;
+    std::vector<TokenKind> all_kinds;
+    std::vector<size_t> batch_sizes;
+
+    TokenParser local_parser;
+    local_parser.ParseBatched(text, buffer, [&](const TokenBatch& batch) {
+        batch_sizes.push_back(batch.size);
+        EXPECT_EQ(batch.number_count + batch.string_count, batch.size);
+        all_numbers.insert(all_numbers.end(), batch.numbers, batch.numbers + batch.number_count);
+        for (size_t i = 0; i < batch.string_count; ++i)
+            all_strings.push_back(text.substr(batch.offsets[i], batch.lengths[i]));
+        all_kinds.insert(all_kinds.end(), batch.kinds, batch.kinds + batch.size);
+    });
+
+    EXPECT_EQ(batch_sizes, (std::vector<size_t>{3, 3, 1}));
+    EXPECT_EQ(all_numbers, (std::vector<uint64_t>{123, 456, 789}));
+    EXPECT_EQ(all_strings, (std::vector<std::string>{"first", "second", "third", "fourth"}));
+    ASSERT_EQ(all_kinds.size(), 7);
+    for (size_t i = 0; i < all_kinds.size(); ++i)
+        EXPECT_EQ(all_kinds[i], i % 2 ? TokenKind::Digit : TokenKind::String);
+}
+
+TEST(TokenBatchTest, ZeroCapacity) {
+    TokenBatchBuffer buffer{nullptr, nullptr, nullptr, nullptr, 0};
+    EXPECT_THROW(ParseBatched("1 2", buffer, [](const TokenBatch&) {}), std::invalid_argument);
+}
+
+TEST(TokenInternerTest, DenseIds) {
+    TokenInterner interner;
+    EXPECT_EQ(interner.Intern("apple"), 0);
+    EXPECT_EQ(interner.Intern("pear"), 1);
+    EXPECT_EQ(interner.Intern("apple"), 0);
+    EXPECT_EQ(interner.Intern(""), 2);
+    EXPECT_EQ(interner.size(), 3);
+
+    EXPECT_EQ(interner.Find("pear"), 1);
+    EXPECT_EQ(interner.Find("plum"), TokenInterner::kInvalidId);
+    EXPECT_EQ(interner.Lookup(1), "pear");
+    EXPECT_THROW(interner.Lookup(3), std::out_of_range);
+
+    std::ostringstream oss;
+    interner.DumpVocabulary(oss);
+    EXPECT_EQ(oss.str(), "0 apple\n1 pear\n2 \n");
+}
+
+TEST(TokenInternerTest, GrowthAndCopy) {
+    TokenInterner interner;
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(interner.Intern("token" + std::to_string(i)), static_cast<uint32_t>(i));
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(interner.Find("token" + std::to_string(i)), static_cast<uint32_t>(i));
+
+    TokenInterner copy = interner;
+    interner.clear();
+    EXPECT_EQ(interner.size(), 0);
+    EXPECT_EQ(interner.Find("token7"), TokenInterner::kInvalidId);
+    EXPECT_EQ(copy.size(), 10000);
+    EXPECT_EQ(copy.Lookup(9999), "token9999");
+}
+
+TEST(TokenInternerTest, ReuseAfterMove) {
+    TokenInterner interner;
+    interner.Intern("alpha");
+    interner.Intern("beta");
+
+    TokenInterner moved(std::move(interner));
+    EXPECT_EQ(interner.size(), 0);
+    EXPECT_EQ(interner.Find("alpha"), TokenInterner::kInvalidId);
+    EXPECT_EQ(interner.Intern("gamma"), 0);
+    EXPECT_EQ(interner.Intern("alpha"), 1);
+    EXPECT_EQ(interner.Lookup(0), "gamma");
+
+    TokenInterner assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.Lookup(1), "beta");
+    EXPECT_EQ(moved.size(), 0);
+    EXPECT_EQ(moved.Intern("delta"), 0);
+    EXPECT_EQ(moved.Intern("delta"), 0);
+    EXPECT_EQ(moved.Vocabulary(), (std::vector<std::string_view>{"delta"}));
+    EXPECT_EQ(assigned.Intern("alpha"), 0);
+}
+
+TEST_F(TokenParserTest, StringIdCallback) {
+    std::vector<uint32_t> ids;
+    parser.SetStringIdCallback([&ids](uint32_t id) { ids.push_back(id); });
+    parser.Parse("red green 1 red blue green red");
+
+    EXPECT_EQ(ids, (std::vector<uint32_t>{0, 1, 0, 2, 1, 0}));
+    EXPECT_EQ(digit_tokens, (std::vector<uint64_t>{1}));
+    EXPECT_TRUE(string_tokens.empty());
+    EXPECT_EQ(parser.Interner().Vocabulary(), (std::vector<std::string_view>{"red", "green", "blue"}));
+}
+
+TEST(BasicTokenParserTest, InterningCallback) {
+    TokenInterner interner;
+    std::vector<uint32_t> ids;
+
+    BasicTokenParser parser(nullptr, InterningCallback(interner, [&ids](uint32_t id) { ids.push_back(id); }));
+    parser.Parse("a b a 7 b");
+
+    EXPECT_EQ(ids, (std::vector<uint32_t>{0, 1, 0, 2, 1}));
+    EXPECT_EQ(interner.Lookup(2), "7");
+}
+
+TEST(TokenRangeTest, PullTokens) {
+    std::string text = "  hello 123\tworld 99999999999999999999999 ";
+    std::vector<Token> result;
+    for (const Token& token : tokens(text))
+        result.push_back(token);
+
+    ASSERT_EQ(result.size(), 4);
+    EXPECT_EQ(std::get<std::string_view>(result[0]), "hello");
+    EXPECT_EQ(std::get<uint64_t>(result[1]), 123);
+    EXPECT_EQ(std::get<std::string_view>(result[2]), "world");
+    EXPECT_EQ(std::get<std::string_view>(result[3]), "99999999999999999999999");
+    EXPECT_EQ(std::get<std::string_view>(result[0]).data(), text.data() + 2);
+}
+
+TEST(TokenRangeTest, EmptyInput) {
+    TokenView empty = tokens("");
+    TokenView blank = tokens(" \t\n ");
+    EXPECT_TRUE(empty.begin() == empty.end());
+    EXPECT_TRUE(blank.begin() == blank.end());
+}
+
+TEST(TokenRangeTest, RangesPipeline) {
+    static_assert(std::ranges::input_range<TokenView>);
+    static_assert(std::ranges::view<TokenView>);
+
+    std::string_view text = "1 a 2 b 3 c 4";
+    std::vector<uint64_t> numbers;
+    auto is_number = [](const Token& token) { return std::holds_alternative<uint64_t>(token); };
+    for (const Token& token : tokens(text) | std::views::filter(is_number) | std::views::take(3))
+        numbers.push_back(std::get<uint64_t>(token));
+
+    EXPECT_EQ(numbers, (std::vector<uint64_t>{1, 2, 3}));
+}
+
+TEST(TokenRangeTest, StopsEarly) {
+    std::string text = "first second";
+    auto view = tokens(text, CharClassTable::Delimiters(" "));
+    auto it = view.begin();
+    EXPECT_EQ(std::get<std::string_view>(*it), "first");
+    text[7] = '!';
+    ++it;
+    EXPECT_EQ(std::get<std::string_view>(*it), "s!cond");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
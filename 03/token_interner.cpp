@@ -0,0 +1,159 @@
+#include "token_interner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t kMinSlots = 16;
+constexpr size_t kArenaBlockSize = 64 * 1024;
+
+size_t SlotCountFor(size_t tokens) {
+    size_t count = kMinSlots;
+    while (count < tokens * 2) count *= 2;
+    return count;
+}
+
+}
+
+TokenInterner::TokenInterner()
+    : TokenInterner(0) {}
+
+TokenInterner::TokenInterner(size_t expected_tokens)
+    : _slots(SlotCountFor(expected_tokens), Slot{0, kInvalidId}) {
+    _keys.reserve(expected_tokens);
+}
+
+TokenInterner::TokenInterner(const TokenInterner& other)
+    : TokenInterner(other._keys.size()) {
+    for (std::string_view key : other._keys)
+        Intern(key);
+}
+
+TokenInterner::TokenInterner(TokenInterner&& other) noexcept
+    : _slots(std::move(other._slots)),
+      _keys(std::move(other._keys)),
+      _blocks(std::move(other._blocks)),
+      _block_used(other._block_used),
+      _block_size(other._block_size) {
+    other.Release();
+}
+
+TokenInterner& TokenInterner::operator=(const TokenInterner& other) {
+    if (this != &other) {
+        TokenInterner copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+TokenInterner& TokenInterner::operator=(TokenInterner&& other) noexcept {
+    if (this != &other) {
+        _slots = std::move(other._slots);
+        _keys = std::move(other._keys);
+        _blocks = std::move(other._blocks);
+        _block_used = other._block_used;
+        _block_size = other._block_size;
+        other.Release();
+    }
+    return *this;
+}
+
+uint32_t TokenInterner::Intern(std::string_view token) {
+    if (_slots.empty()) Rehash(kMinSlots);
+    uint32_t hash = Hash(token);
+    size_t pos = FindSlot(token, hash);
+    if (_slots[pos].id != kInvalidId) return _slots[pos].id;
+
+    if (_keys.size() >= kInvalidId) throw std::length_error("Too many distinct tokens");
+    uint32_t id = static_cast<uint32_t>(_keys.size());
+    _keys.push_back(StoreKey(token));
+    _slots[pos] = Slot{hash, id};
+    if (_keys.size() * 2 > _slots.size()) Rehash(_slots.size() * 2);
+    return id;
+}
+
+uint32_t TokenInterner::Find(std::string_view token) const {
+    if (_slots.empty()) return kInvalidId;
+    return _slots[FindSlot(token, Hash(token))].id;
+}
+
+std::string_view TokenInterner::Lookup(uint32_t id) const {
+    if (id >= _keys.size()) throw std::out_of_range("Token id out of range");
+    return _keys[id];
+}
+
+size_t TokenInterner::size() const noexcept {
+    return _keys.size();
+}
+
+const std::vector<std::string_view>& TokenInterner::Vocabulary() const noexcept {
+    return _keys;
+}
+
+void TokenInterner::DumpVocabulary(std::ostream& os) const {
+    for (size_t id = 0; id < _keys.size(); ++id)
+        os << id << " " << _keys[id] << "\n";
+}
+
+void TokenInterner::clear() noexcept {
+    std::fill(_slots.begin(), _slots.end(), Slot{0, kInvalidId});
+    _keys.clear();
+    _blocks.clear();
+    _block_used = 0;
+    _block_size = 0;
+}
+
+// Пустое состояние после перемещения: таблица без слотов создаётся заново при первом Intern
+void TokenInterner::Release() noexcept {
+    _slots.clear();
+    _keys.clear();
+    _blocks.clear();
+    _block_used = 0;
+    _block_size = 0;
+}
+
+uint32_t TokenInterner::Hash(std::string_view token) noexcept {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : token) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+size_t TokenInterner::FindSlot(std::string_view token, uint32_t hash) const noexcept {
+    size_t mask = _slots.size() - 1;
+    size_t pos = hash & mask;
+    while (_slots[pos].id != kInvalidId) {
+        if (_slots[pos].hash == hash && _keys[_slots[pos].id] == token) return pos;
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+void TokenInterner::Rehash(size_t slot_count) {
+    std::vector<Slot> slots(slot_count, Slot{0, kInvalidId});
+    size_t mask = slot_count - 1;
+    for (const Slot& slot : _slots) {
+        if (slot.id == kInvalidId) continue;
+        size_t pos = slot.hash & mask;
+        while (slots[pos].id != kInvalidId) pos = (pos + 1) & mask;
+        slots[pos] = slot;
+    }
+    _slots = std::move(slots);
+}
+
+std::string_view TokenInterner::StoreKey(std::string_view token) {
+    if (token.empty()) return std::string_view();
+    if (_block_used + token.size() > _block_size) {
+        _block_size = std::max(kArenaBlockSize, token.size());
+        _blocks.push_back(std::make_unique<char[]>(_block_size));
+        _block_used = 0;
+    }
+    char* dst = _blocks.back().get() + _block_used;
+    std::memcpy(dst, token.data(), token.size());
+    _block_used += token.size();
+    return std::string_view(dst, token.size());
+}
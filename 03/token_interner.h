@@ -0,0 +1,73 @@
+#ifndef TOKEN_INTERNER_H
+#define TOKEN_INTERNER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Словарное кодирование строковых токенов: каждому различному токену выдаётся плотный id 0, 1, 2, ...
+// Ключи хранятся в арене, поэтому string_view из Lookup и Vocabulary живут, пока жив интернер
+class TokenInterner
+{
+public:
+    static constexpr uint32_t kInvalidId = UINT32_MAX;
+
+    TokenInterner();
+    explicit TokenInterner(size_t expected_tokens);
+
+    TokenInterner(const TokenInterner& other);
+    TokenInterner(TokenInterner&& other) noexcept;
+
+    TokenInterner& operator=(const TokenInterner& other);
+    TokenInterner& operator=(TokenInterner&& other) noexcept;
+
+    uint32_t Intern(std::string_view token);
+    uint32_t Find(std::string_view token) const;
+    std::string_view Lookup(uint32_t id) const;
+
+    size_t size() const noexcept;
+    const std::vector<std::string_view>& Vocabulary() const noexcept;
+    void DumpVocabulary(std::ostream& os) const;
+
+    void clear() noexcept;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;
+    };
+
+    static uint32_t Hash(std::string_view token) noexcept;
+    size_t FindSlot(std::string_view token, uint32_t hash) const noexcept;
+    void Rehash(size_t slot_count);
+    void Release() noexcept;
+    std::string_view StoreKey(std::string_view token);
+
+    std::vector<Slot> _slots;
+    std::vector<std::string_view> _keys;
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    size_t _block_used = 0;
+    size_t _block_size = 0;
+};
+
+template<class IdFn>
+class InterningCallback
+{
+public:
+    InterningCallback(TokenInterner& interner, IdFn id_callback)
+        : _interner(&interner), _id_callback(std::move(id_callback)) {}
+
+    void operator()(std::string_view token) { _id_callback(_interner->Intern(token)); }
+
+private:
+    TokenInterner* _interner;
+    IdFn _id_callback;
+};
+
+template<class IdFn>
+InterningCallback(TokenInterner&, IdFn) -> InterningCallback<IdFn>;
+
+#endif
@@ -1,44 +1,59 @@
 #include "token_parser.h"
 
-void TokenParser::SetDigitTokenCallback(func_digit_ptr callback) { 
-    _digit_callback = callback; 
+TokenParser::StringCallbacks::operator bool() const {
+    return static_cast<bool>(id) || static_cast<bool>(view) || static_cast<bool>(str);
 }
 
-void TokenParser::SetStringTokenCallback(func_str_ptr callback) { 
-    _string_callback = callback; 
+void TokenParser::StringCallbacks::operator()(std::string_view token) {
+    if (id) id(interner.Intern(token));
+    else if (view) view(token);
+    else str(std::string(token));
+}
+
+void TokenParser::SetDigitTokenCallback(func_digit_ptr callback) {
+    _parser._digit_callback = std::move(callback);
+}
+
+void TokenParser::SetStringTokenCallback(func_str_ptr callback) {
+    _parser._string_callback.str = std::move(callback);
+}
+
+void TokenParser::SetStringViewTokenCallback(func_str_view_ptr callback) {
+    _parser._string_callback.view = std::move(callback);
+}
+
+void TokenParser::SetStringIdCallback(func_id_ptr callback) {
+    _parser._string_callback.id = std::move(callback);
+}
+
+const TokenInterner& TokenParser::Interner() const {
+    return _parser._string_callback.interner;
+}
+
+void TokenParser::SetSignedTokenCallback(func_signed_ptr callback) {
+    _parser._signed_callback = std::move(callback);
+}
+
+void TokenParser::SetHexTokenCallback(func_hex_ptr callback) {
+    _parser._hex_callback = std::move(callback);
+}
+
+void TokenParser::SetDoubleTokenCallback(func_double_ptr callback) {
+    _parser._double_callback = std::move(callback);
+}
+
+void TokenParser::SetDelimiters(std::string_view delimiters) {
+    _parser._classes = CharClassTable::Delimiters(delimiters);
 }
 
 void TokenParser::Parse(const std::string &text) {
-    size_t i = 0, n = text.length();
-    while (i < n) {
-        while (i < n && std::isspace(text[i])) { ++i; }
-        if (i >= n) { break; }
-        size_t start = i;
-        while (i < n && !std::isspace(text[i])) { ++i; }
-        size_t end = i;
-        std::string token = text.substr(start, end - start);
-        ProcessToken(token);
-    }
-}
-
-void TokenParser::ProcessToken(const std::string& token) {
-    bool is_digit = !token.empty();
-    for (char c : token) {
-        if (!std::isdigit(c)) {
-            is_digit = false;
-            break;
-        }
-    }
-    if (is_digit) {
-        try {
-            uint64_t number = std::stoull(token);
-            if (_digit_callback) { 
-                _digit_callback(number);
-                return;
-            }
-        } catch (const std::out_of_range&) {
-        } catch (const std::invalid_argument&) {
-        }
-    }
-    if (_string_callback) { _string_callback(token); }
-}
\ No newline at end of file
+    _parser.Parse(text);
+}
+
+void TokenParser::ParseFile(const std::string &path) {
+    _parser.ParseFile(path);
+}
+
+void TokenParser::ParseBatched(const std::string &text, const TokenBatchBuffer& buffer, func_batch_ptr callback) const {
+    ::ParseBatched(text, buffer, callback, _parser._classes);
+}
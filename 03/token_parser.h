@@ -4,14 +4,148 @@
 #include <iostream>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <cctype>
 #include <cstdint>
+#include <cstddef>
 #include <sstream>
+#include <type_traits>
+#include <array>
+#include <stdexcept>
+#include "mapped_file.h"
+#include "token_interner.h"
+
+class TokenParser;
+
+class CharClassTable
+{
+public:
+    enum : uint8_t {
+        kDelimiter = 1 << 0,
+        kDigit = 1 << 1,
+        kHexDigit = 1 << 2,
+    };
+
+    constexpr CharClassTable() : _classes() {
+        for (int c = '0'; c <= '9'; ++c) _classes[c] |= kDigit | kHexDigit;
+        for (int c = 'a'; c <= 'f'; ++c) _classes[c] |= kHexDigit;
+        for (int c = 'A'; c <= 'F'; ++c) _classes[c] |= kHexDigit;
+    }
+
+    static constexpr CharClassTable Delimiters(std::string_view delimiters) {
+        CharClassTable table;
+        for (char c : delimiters) table._classes[static_cast<unsigned char>(c)] |= kDelimiter;
+        return table;
+    }
+
+    constexpr bool Is(char c, uint8_t cls) const {
+        return _classes[static_cast<unsigned char>(c)] & cls;
+    }
+
+    constexpr bool IsDelimiter(char c) const { return Is(c, kDelimiter); }
+
+private:
+    std::array<uint8_t, 256> _classes;
+};
+
+// Совпадает с std::isspace в локали "C"
+inline constexpr CharClassTable kWhitespaceDelimiters = CharClassTable::Delimiters(" \t\n\v\f\r");
+
+enum class TokenKind : uint8_t { Digit, String };
+
+constexpr size_t kTokenBatchSize = 4096;
+
+// Буферы вызывающей стороны; каждый массив должен вмещать capacity элементов
+struct TokenBatchBuffer {
+    uint64_t* numbers;
+    size_t* offsets;
+    size_t* lengths;
+    TokenKind* kinds;
+    size_t capacity;
+};
+
+// Числа и строки лежат плотно в своих массивах, kinds хранит порядок токенов во входе.
+// offsets отсчитываются от начала разбираемого текста
+struct TokenBatch {
+    const uint64_t* numbers;
+    size_t number_count;
+    const size_t* offsets;
+    const size_t* lengths;
+    size_t string_count;
+    const TokenKind* kinds;
+    size_t size;
+};
+
+// SignedFn получает int64_t со знаком, HexFn - uint64_t из записи 0x..., DoubleFn - double.
+// Токены, для которых колбэк не задан (nullptr), уходят в StringFn
+template<
+    class DigitFn,
+    class StringFn,
+    class SignedFn = std::nullptr_t,
+    class HexFn = std::nullptr_t,
+    class DoubleFn = std::nullptr_t
+>
+class BasicTokenParser
+{
+public:
+    BasicTokenParser() = default;
+    BasicTokenParser(DigitFn digit_callback, StringFn string_callback,
+                     SignedFn signed_callback = SignedFn(), HexFn hex_callback = HexFn(),
+                     DoubleFn double_callback = DoubleFn());
+    BasicTokenParser(const CharClassTable& classes, DigitFn digit_callback, StringFn string_callback,
+                     SignedFn signed_callback = SignedFn(), HexFn hex_callback = HexFn(),
+                     DoubleFn double_callback = DoubleFn());
+
+    void Parse(std::string_view text);
+
+    void ParseFile(const std::string& path);
+
+private:
+    friend class TokenParser;
+
+    void ProcessToken(std::string_view token);
+    bool ProcessNumber(std::string_view token);
+
+    CharClassTable _classes = kWhitespaceDelimiters;
+    DigitFn _digit_callback{};
+    StringFn _string_callback{};
+    SignedFn _signed_callback{};
+    HexFn _hex_callback{};
+    DoubleFn _double_callback{};
+};
+
+template<class DigitFn, class StringFn, class... ExtraFns>
+BasicTokenParser(DigitFn, StringFn, ExtraFns...) -> BasicTokenParser<DigitFn, StringFn, ExtraFns...>;
+
+template<class DigitFn, class StringFn, class... ExtraFns>
+BasicTokenParser(const CharClassTable&, DigitFn, StringFn, ExtraFns...)
+    -> BasicTokenParser<DigitFn, StringFn, ExtraFns...>;
+
+template<class BatchFn>
+void ParseBatched(std::string_view text, const TokenBatchBuffer& buffer, BatchFn&& callback,
+                  const CharClassTable& classes = kWhitespaceDelimiters);
 
 class TokenParser
 {
     using func_digit_ptr = std::function<void(uint64_t)>;
     using func_str_ptr = std::function<void(const std::string&)>;
+    using func_str_view_ptr = std::function<void(std::string_view)>;
+    using func_id_ptr = std::function<void(uint32_t)>;
+    using func_signed_ptr = std::function<void(int64_t)>;
+    using func_hex_ptr = std::function<void(uint64_t)>;
+    using func_double_ptr = std::function<void(double)>;
+    using func_batch_ptr = std::function<void(const TokenBatch&)>;
+
+    // Вызывается первый заданный колбэк: id из словаря, затем string_view, затем std::string
+    struct StringCallbacks {
+        func_str_ptr str;
+        func_str_view_ptr view;
+        func_id_ptr id;
+        TokenInterner interner;
+
+        explicit operator bool() const;
+        void operator()(std::string_view token);
+    };
 
 public:
     TokenParser() = default;
@@ -20,13 +154,30 @@ public:
 
     void SetStringTokenCallback(func_str_ptr callback);
 
+    void SetStringViewTokenCallback(func_str_view_ptr callback);
+
+    void SetStringIdCallback(func_id_ptr callback);
+
+    const TokenInterner& Interner() const;
+
+    void SetSignedTokenCallback(func_signed_ptr callback);
+
+    void SetHexTokenCallback(func_hex_ptr callback);
+
+    void SetDoubleTokenCallback(func_double_ptr callback);
+
+    void SetDelimiters(std::string_view delimiters);
+
     void Parse(const std::string &text);
 
-private:
-    void ProcessToken(const std::string& token);
+    void ParseFile(const std::string &path);
+
+    void ParseBatched(const std::string &text, const TokenBatchBuffer& buffer, func_batch_ptr callback) const;
 
-    func_digit_ptr _digit_callback = nullptr;
-    func_str_ptr _string_callback = nullptr;
+private:
+    BasicTokenParser<func_digit_ptr, StringCallbacks, func_signed_ptr, func_hex_ptr, func_double_ptr> _parser;
 };
 
-#endif
\ No newline at end of file
+#include "token_parser.hpp"
+
+#endif
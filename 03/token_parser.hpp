@@ -0,0 +1,186 @@
+#ifndef TOKEN_PARSER_HPP
+#define TOKEN_PARSER_HPP
+
+#include <charconv>
+
+namespace token_parser_detail {
+
+inline bool IsDecimal(std::string_view token) {
+    if (token.empty()) return false;
+    for (char c : token)
+        if (static_cast<unsigned char>(c - '0') > 9) return false;
+    return true;
+}
+
+template<class T>
+bool ParseInteger(std::string_view token, T& value, int base = 10) {
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value, base);
+    return ec == std::errc() && ptr == token.data() + token.size();
+}
+
+inline bool ParseUnsigned(std::string_view token, uint64_t& value) {
+    return IsDecimal(token) && ParseInteger(token, value);
+}
+
+inline bool IsSign(char c) {
+    return c == '+' || c == '-';
+}
+
+// Допускается ровно один знак; from_chars не принимает '+', поэтому он снимается перед разбором
+inline bool ParseSigned(std::string_view token, int64_t& value) {
+    if (token.empty()) return false;
+    std::string_view digits = token;
+    if (IsSign(digits[0])) digits.remove_prefix(1);
+    if (!IsDecimal(digits)) return false;
+    if (token[0] == '+') token.remove_prefix(1);
+    return ParseInteger(token, value);
+}
+
+inline bool ParseHex(std::string_view token, const CharClassTable& classes, uint64_t& value) {
+    if (token.size() < 3 || token[0] != '0' || (token[1] != 'x' && token[1] != 'X')) return false;
+    token.remove_prefix(2);
+    for (char c : token)
+        if (!classes.Is(c, CharClassTable::kHexDigit)) return false;
+    return ParseInteger(token, value, 16);
+}
+
+// inf и nan не считаются числами, мантисса должна начинаться с цифры или точки
+inline bool ParseDouble(std::string_view token, const CharClassTable& classes, double& value) {
+    if (token.empty()) return false;
+    size_t i = IsSign(token[0]) ? 1 : 0;
+    if (i >= token.size()) return false;
+    if (!classes.Is(token[i], CharClassTable::kDigit) &&
+        !(token[i] == '.' && i + 1 < token.size() && classes.Is(token[i + 1], CharClassTable::kDigit)))
+        return false;
+    if (token[0] == '+') token.remove_prefix(1);
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return ec == std::errc() && ptr == token.data() + token.size();
+}
+
+// Колбэк считается заданным, если это не nullptr и не пустая std::function
+template<class Fn>
+bool HasCallback(const Fn& fn) {
+    if constexpr (std::is_same_v<Fn, std::nullptr_t>) return false;
+    else if constexpr (std::is_constructible_v<bool, const Fn&>) return static_cast<bool>(fn);
+    else return true;
+}
+
+template<class Fn>
+void InvokeStringCallback(Fn& fn, std::string_view token) {
+    if constexpr (std::is_invocable_v<Fn&, std::string_view>) fn(token);
+    else fn(std::string(token));
+}
+
+}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::BasicTokenParser(
+    DigitFn digit_callback, StringFn string_callback,
+    SignedFn signed_callback, HexFn hex_callback, DoubleFn double_callback)
+    : _digit_callback(std::move(digit_callback)), _string_callback(std::move(string_callback)),
+      _signed_callback(std::move(signed_callback)), _hex_callback(std::move(hex_callback)),
+      _double_callback(std::move(double_callback)) {}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::BasicTokenParser(
+    const CharClassTable& classes, DigitFn digit_callback, StringFn string_callback,
+    SignedFn signed_callback, HexFn hex_callback, DoubleFn double_callback)
+    : _classes(classes), _digit_callback(std::move(digit_callback)),
+      _string_callback(std::move(string_callback)), _signed_callback(std::move(signed_callback)),
+      _hex_callback(std::move(hex_callback)), _double_callback(std::move(double_callback)) {}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+void BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::Parse(std::string_view text) {
+    const char* i = text.data();
+    const char* n = i + text.size();
+    while (i < n) {
+        while (i < n && _classes.IsDelimiter(*i)) { ++i; }
+        if (i >= n) { break; }
+        const char* start = i;
+        while (i < n && !_classes.IsDelimiter(*i)) { ++i; }
+        ProcessToken(std::string_view(start, i - start));
+    }
+}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+void BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::ParseFile(const std::string& path) {
+    MappedFile file(path);
+    Parse(file.view());
+}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+void BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::ProcessToken(std::string_view token) {
+    if (ProcessNumber(token)) return;
+    if constexpr (!std::is_same_v<StringFn, std::nullptr_t>) {
+        if (token_parser_detail::HasCallback(_string_callback))
+            token_parser_detail::InvokeStringCallback(_string_callback, token);
+    }
+}
+
+template<class DigitFn, class StringFn, class SignedFn, class HexFn, class DoubleFn>
+bool BasicTokenParser<DigitFn, StringFn, SignedFn, HexFn, DoubleFn>::ProcessNumber(std::string_view token) {
+    using namespace token_parser_detail;
+
+    if constexpr (!std::is_same_v<DigitFn, std::nullptr_t>) {
+        uint64_t number = 0;
+        if (HasCallback(_digit_callback) && ParseUnsigned(token, number)) {
+            _digit_callback(number);
+            return true;
+        }
+    }
+    if constexpr (!std::is_same_v<SignedFn, std::nullptr_t>) {
+        int64_t number = 0;
+        if (HasCallback(_signed_callback) && ParseSigned(token, number)) {
+            _signed_callback(number);
+            return true;
+        }
+    }
+    if constexpr (!std::is_same_v<HexFn, std::nullptr_t>) {
+        uint64_t number = 0;
+        if (HasCallback(_hex_callback) && ParseHex(token, _classes, number)) {
+            _hex_callback(number);
+            return true;
+        }
+    }
+    if constexpr (!std::is_same_v<DoubleFn, std::nullptr_t>) {
+        double number = 0;
+        if (HasCallback(_double_callback) && ParseDouble(token, _classes, number)) {
+            _double_callback(number);
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class BatchFn>
+void ParseBatched(std::string_view text, const TokenBatchBuffer& buffer, BatchFn&& callback,
+                  const CharClassTable& classes) {
+    if (buffer.capacity == 0) throw std::invalid_argument("Token batch capacity must be positive");
+
+    TokenBatch batch{buffer.numbers, 0, buffer.offsets, buffer.lengths, 0, buffer.kinds, 0};
+    auto flush = [&batch, &callback]() {
+        if (batch.size == 0) return;
+        callback(static_cast<const TokenBatch&>(batch));
+        batch.number_count = 0;
+        batch.string_count = 0;
+        batch.size = 0;
+    };
+
+    BasicTokenParser parser(
+        classes,
+        [&batch, &buffer, &flush](uint64_t number) {
+            buffer.numbers[batch.number_count++] = number;
+            buffer.kinds[batch.size++] = TokenKind::Digit;
+            if (batch.size == buffer.capacity) flush();
+        },
+        [&batch, &buffer, &flush, text](std::string_view token) {
+            buffer.offsets[batch.string_count] = static_cast<size_t>(token.data() - text.data());
+            buffer.lengths[batch.string_count++] = token.size();
+            buffer.kinds[batch.size++] = TokenKind::String;
+            if (batch.size == buffer.capacity) flush();
+        });
+    parser.Parse(text);
+    flush();
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TOKEN_RANGE_H
+#define TOKEN_RANGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include "token_parser.h"
+
+using Token = std::variant<uint64_t, std::string_view>;
+
+// Ленивый диапазон токенов: очередной токен ищется только при инкременте итератора.
+// Текст не копируется и должен пережить диапазон, таблица классов хранится в самом TokenView
+class TokenView : public std::ranges::view_interface<TokenView>
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = Token;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        const Token& operator*() const { return _token; }
+        const Token* operator->() const { return &_token; }
+
+        iterator& operator++() {
+            Advance();
+            return *this;
+        }
+
+        void operator++(int) { Advance(); }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) { return it._done; }
+
+    private:
+        friend class TokenView;
+
+        iterator(std::string_view text, const CharClassTable* classes)
+            : _rest(text), _classes(classes), _done(false) {
+            Advance();
+        }
+
+        void Advance() {
+            const char* i = _rest.data();
+            const char* n = i + _rest.size();
+            while (i < n && _classes->IsDelimiter(*i)) { ++i; }
+            if (i >= n) {
+                _done = true;
+                _rest = std::string_view();
+                return;
+            }
+            const char* start = i;
+            while (i < n && !_classes->IsDelimiter(*i)) { ++i; }
+            std::string_view token(start, i - start);
+            _rest = std::string_view(i, n - i);
+
+            uint64_t number = 0;
+            if (token_parser_detail::ParseUnsigned(token, number)) _token = number;
+            else _token = token;
+        }
+
+        std::string_view _rest;
+        const CharClassTable* _classes = &kWhitespaceDelimiters;
+        Token _token;
+        bool _done = true;
+    };
+
+    TokenView() = default;
+    explicit TokenView(std::string_view text, const CharClassTable& classes = kWhitespaceDelimiters)
+        : _text(text), _classes(classes) {}
+
+    iterator begin() const { return iterator(_text, &_classes); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+    std::string_view _text;
+    CharClassTable _classes = kWhitespaceDelimiters;
+};
+
+inline TokenView tokens(std::string_view text, const CharClassTable& classes = kWhitespaceDelimiters) {
+    return TokenView(text, classes);
+}
+
+template<class String>
+    requires std::is_same_v<String, std::string>
+TokenView tokens(String&& text, const CharClassTable& classes = kWhitespaceDelimiters) = delete;
+
+#endif
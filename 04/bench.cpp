@@ -0,0 +1,175 @@
+#include "matrix.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static volatile int64_t g_sink = 0;
+
+// Не даёт компилятору свернуть вычисления над value на этапе компиляции или выкинуть их
+template<class T>
+static void Escape(T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+struct Result {
+    double seconds;
+    size_t iterations;
+};
+
+// Повторяет run, пока суммарное время не превысит kMinSeconds, и берёт лучшее среднее из kRepeats серий
+static const double kMinSeconds = 0.2;
+static const int kRepeats = 3;
+
+template<class Fn>
+static Result Measure(Fn&& run) {
+    Result best{1e100, 0};
+    for (int r = 0; r < kRepeats; ++r) {
+        size_t iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            run();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < kMinSeconds);
+        if (elapsed / iterations < best.seconds) best = Result{elapsed / iterations, iterations};
+    }
+    return best;
+}
+
+// ops - число арифметических операций за вызов, bytes - сколько байт он обязан прочитать и записать
+static void Report(const char* op, size_t n, size_t threads, const Result& result, double ops, double bytes) {
+    std::printf("%-20s %6zu %7zu %12.4f %10.2f %10.2f\n", op, n, threads, result.seconds * 1e3,
+                ops / result.seconds / 1e9, bytes / result.seconds / 1e9);
+}
+
+static Matrix RandomMatrix(size_t n, size_t m, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int32_t> value(-100, 100);
+    Matrix res(n, m);
+    for (size_t i = 0; i < n; ++i)
+        for (int32_t& x : res.row(i)) x = value(rng);
+    return res;
+}
+
+static void RunElementwise(size_t n, size_t threads) {
+    const double elems = static_cast<double>(n) * n;
+    const double bytes = elems * sizeof(int32_t);
+    Matrix a = RandomMatrix(n, n, 1);
+    Matrix b = RandomMatrix(n, n, 2);
+    Matrix c(n, n);
+
+    Report("a + b", n, threads, Measure([&]() { c = a + b; g_sink = c(0, 0); }), elems, 3 * bytes);
+    Report("a + b * 3 (fused)", n, threads, Measure([&]() { c = lazyAdd(a, lazyScale(b, 3)); g_sink = c(0, 0); }), 2 * elems, 3 * bytes);
+    Report("a += b", n, threads, Measure([&]() { a += b; g_sink = a(0, 0); }), elems, 3 * bytes);
+    Report("a *= k", n, threads, Measure([&]() { a *= 3; g_sink = a(0, 0); }), elems, 2 * bytes);
+    Report("add saturate", n, threads, Measure([&]() {
+        c = a.add(b, Overflow::Saturate);
+        g_sink = c(0, 0);
+    }), elems, 3 * bytes);
+    Report("add checked", n, threads, Measure([&]() {
+        c = a.add(b, Overflow::Wrap).add(b, Overflow::Checked);
+        g_sink = c(0, 0);
+    }), 2 * elems, 6 * bytes);
+    Report("scale saturate", n, threads, Measure([&]() { a.scale(3, Overflow::Saturate); g_sink = a(0, 0); }),
+           elems, 2 * bytes);
+    Report("copy", n, threads, Measure([&]() { Matrix copy(a); g_sink = copy(0, 0); }), 0, 2 * bytes);
+    Report("copy assign", n, threads, Measure([&]() { c = a; g_sink = c(0, 0); }), 0, 2 * bytes);
+    Report("move", n, threads, Measure([&]() {
+        Matrix moved(std::move(a));
+        a = std::move(moved);
+        g_sink = a(0, 0);
+    }), 0, 0);
+    Report("transpose", n, threads, Measure([&]() { c = a.transpose(); g_sink = c(0, 0); }), 0, 2 * bytes);
+    Report("transposeInPlace", n, threads, Measure([&]() { a.transposeInPlace(); g_sink = a(0, 0); }), 0, 2 * bytes);
+}
+
+static void RunProduct(size_t n, size_t threads) {
+    const double ops = 2.0 * n * n * n;
+    const double bytes = 3.0 * n * n * sizeof(int32_t);
+    Matrix a = RandomMatrix(n, n, 3);
+    Matrix b = RandomMatrix(n, n, 4);
+
+    Report("a * b", n, threads, Measure([&]() { Matrix c = a * b; g_sink = c(0, 0); }), ops, bytes);
+    Report("a * b (int64 acc)", n, threads, Measure([&]() {
+        Matrix c = a.multiply(b, Matrix::Accumulation::Int64);
+        g_sink = c(0, 0);
+    }), ops, bytes);
+    Report("a^T * b (view)", n, threads, Measure([&]() {
+        Matrix c = a.view().transposed() * b.view();
+        g_sink = c(0, 0);
+    }), ops, bytes);
+
+    BasicMatrix<double> da(n, n);
+    BasicMatrix<double> db(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            da(i, j) = a(i, j) * 0.5;
+            db(i, j) = b(i, j) * 0.25;
+        }
+    Report("double a * b", n, threads, Measure([&]() {
+        BasicMatrix<double> c = da * db;
+        g_sink = static_cast<int64_t>(c(0, 0));
+    }), ops, 2 * bytes);
+}
+
+static void RunFixed() {
+    Matrix4f a = Matrix4f::identity();
+    Matrix4f b = Matrix4f::identity();
+    a(0, 3) = 1.5f;
+    b(1, 2) = 0.5f;
+    const size_t batch = 1 << 16;
+    Report("Matrix4f * (x64k)", 4, 1, Measure([&]() {
+        Matrix4f acc = a;
+        for (size_t i = 0; i < batch; ++i) {
+            Escape(b);
+            acc = acc * b;
+            Escape(acc);
+        }
+        g_sink = static_cast<int64_t>(acc(0, 0));
+    }), 112.0 * batch, 0);
+    Matrix m4(4, 4);
+    Matrix n4(4, 4);
+    for (size_t i = 0; i < 4; ++i) m4(i, i) = n4(i, i) = 1;
+    Report("Matrix 4x4 * (x64k)", 4, 1, Measure([&]() {
+        Matrix acc = m4;
+        for (size_t i = 0; i < batch; ++i) acc = acc * n4;
+        g_sink = acc(0, 0);
+    }), 112.0 * batch, 0);
+}
+
+// Аргументы: наибольший размер для поэлементных операций и наибольший размер для произведения.
+// Произведение 8192 x 8192 занимает минуты, поэтому по умолчанию ограничено 2048
+int main(int argc, char** argv) {
+    size_t max_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8192;
+    size_t max_product = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2048;
+    size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    std::printf("%-20s %6s %7s %12s %10s %10s\n", "op", "n", "threads", "ms/op", "GOP/s", "GB/s");
+
+    ThreadPool::setGlobalThreads(hardware);
+    RunFixed();
+    for (size_t n = 8; n <= max_size; n *= 2)
+        RunElementwise(n, hardware);
+    for (size_t n = 8; n <= std::min(max_size, max_product); n *= 2)
+        RunProduct(n, hardware);
+
+    // Масштабирование по потокам на одном размере, достаточно большом, чтобы работа делилась
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < hardware; t *= 2) counts.push_back(t);
+    counts.push_back(hardware);
+    size_t elementwise_n = std::min<size_t>(max_size, 4096);
+    size_t product_n = std::min<size_t>(std::min(max_size, max_product), 1024);
+    for (size_t threads : counts) {
+        ThreadPool::setGlobalThreads(threads);
+        RunElementwise(elementwise_n, threads);
+        RunProduct(product_n, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Отображает файл в память только для чтения и отдаёт его содержимое как string_view
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    std::string_view view() const noexcept;
+    size_t size() const noexcept;
+
+private:
+    void unmap() noexcept;
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+};
+
+#endif
@@ -5,60 +5,272 @@
 #include <cstddef>
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <string>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "matrix_expr.h"
+#include "matrix_io.h"
+#include "matrix_overflow.h"
+#include "matrix_view.h"
+#include "thread_pool.h"
+
+// Матрица фиксированного размера R x C: лежит на стеке, поэлементные операции и произведение
+// разворачиваются на этапе компиляции
+template<class T, size_t R, size_t C>
+class BasicMatrix {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Matrix element must be a number");
+    static_assert(R != std::dynamic_extent && C != std::dynamic_extent,
+                  "Both dimensions must be either fixed or dynamic");
+    static_assert(R > 0 && C > 0, "Fixed dimensions must be positive");
+
+public:
+    using value_type = T;
+
+    constexpr BasicMatrix() = default;
+    constexpr BasicMatrix(std::initializer_list<std::initializer_list<T>> rows);
+
+    static constexpr BasicMatrix identity();
+
+    static constexpr size_t getRows() { return R; }
+    static constexpr size_t getCols() { return C; }
+
+    constexpr T& operator()(size_t i, size_t j) { return _data[i * C + j]; }
+    constexpr const T& operator()(size_t i, size_t j) const { return _data[i * C + j]; }
+
+    constexpr T& at(size_t i, size_t j);
+    constexpr const T& at(size_t i, size_t j) const;
+
+    constexpr std::span<T, C> row(size_t i);
+    constexpr std::span<const T, C> row(size_t i) const;
+
+    constexpr T* data() noexcept { return _data.data(); }
+    constexpr const T* data() const noexcept { return _data.data(); }
+
+    constexpr BasicMatrix& operator+=(const BasicMatrix& other);
+    constexpr BasicMatrix& operator-=(const BasicMatrix& other);
+    constexpr BasicMatrix& operator*=(T k);
+
+    friend constexpr BasicMatrix operator+(BasicMatrix lhs, const BasicMatrix& rhs) { return lhs += rhs; }
+    friend constexpr BasicMatrix operator-(BasicMatrix lhs, const BasicMatrix& rhs) { return lhs -= rhs; }
+    friend constexpr BasicMatrix operator*(BasicMatrix lhs, T k) { return lhs *= k; }
+    friend constexpr BasicMatrix operator*(T k, BasicMatrix rhs) { return rhs *= k; }
+
+    template<size_t K>
+    constexpr BasicMatrix<T, R, K> operator*(const BasicMatrix<T, C, K>& other) const;
+
+    constexpr BasicMatrix<T, C, R> transpose() const;
+    constexpr void transposeInPlace() requires (R == C);
+
+    constexpr bool operator==(const BasicMatrix& other) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicMatrix& matrix) {
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                os << matrix(i, j) << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
 
-class Matrix {
 private:
-    class ProxyRow {
-        int32_t* _data;
-        size_t _cols;
-    public:
-        ProxyRow(int32_t *data = nullptr, size_t cols = 0);
+    template<class Fn, size_t... I>
+    static constexpr void unroll(Fn&& fn, std::index_sequence<I...>) { (fn(I), ...); }
 
-        ProxyRow(const ProxyRow& other);
-        ProxyRow(ProxyRow&& other) noexcept;
+    std::array<T, R * C> _data{};
+};
 
-        ProxyRow& operator=(const ProxyRow& other);
-        ProxyRow& operator=(ProxyRow&& other) noexcept;
+// Матрица с размерами, известными только во время выполнения
+template<class T>
+class BasicMatrix<T, std::dynamic_extent, std::dynamic_extent> : public MatrixExpr<BasicMatrix<T>> {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Matrix element must be a number");
 
-        ~ProxyRow();
+private:
+    template<class Elem>
+    class Row {
+        Elem* _data;
+        size_t _cols;
+    public:
+        Row(Elem* data = nullptr, size_t cols = 0) : _data(data), _cols(cols) {}
 
-        size_t getCols() const;
+        size_t getCols() const { return _cols; }
 
-        int32_t& operator[](size_t j);
-        const int32_t& operator[](size_t j) const;
+        Elem& operator[](size_t j) const {
+            if (j >= _cols) throw std::out_of_range("Column index out of range");
+            return _data[j];
+        }
     };
+
+    using ProxyRow = Row<T>;
+    using ConstProxyRow = Row<const T>;
+
 public:
-    Matrix(size_t n = 0, size_t m = 0);
+    using value_type = T;
+
+    static constexpr size_t kAlignment = 64;
+    // Поэлементные операции над меньшим числом элементов выполняются в одном потоке
+    static constexpr size_t kParallelThreshold = size_t(1) << 15;
+
+    // Int64: произведение накапливается в int64_t, а если результат не помещается в int32_t,
+    // бросается std::overflow_error вместо молчаливого заворачивания
+    enum class Accumulation { Int32, Int64 };
+
+    BasicMatrix(size_t n = 0, size_t m = 0);
 
-    Matrix(const Matrix& other);
-    Matrix(Matrix&& other) noexcept;
+    BasicMatrix(const BasicMatrix& other);
+    BasicMatrix(BasicMatrix&& other) noexcept;
 
-    Matrix& operator=(const Matrix& other);
-    Matrix& operator=(Matrix&& other) noexcept;
+    template<class E>
+    BasicMatrix(const MatrixExpr<E>& expr);
 
-    ~Matrix();
+    BasicMatrix& operator=(const BasicMatrix& other);
+    BasicMatrix& operator=(BasicMatrix&& other) noexcept;
 
-    size_t getRows() const;
-    size_t getCols() const;
+    template<class E>
+    BasicMatrix& operator=(const MatrixExpr<E>& expr);
 
-    ProxyRow& operator[](size_t i);
-    const ProxyRow& operator[](size_t i) const;
+    ~BasicMatrix();
 
-    Matrix& operator*=(int32_t k);
-    Matrix operator+(const Matrix& other) const;
+    size_t getRows() const { return _n; }
+    size_t getCols() const { return _m; }
 
-    bool operator==(const Matrix& other) const;
-    bool operator!=(const Matrix& other) const;
+    ProxyRow operator[](size_t i);
+    ConstProxyRow operator[](size_t i) const;
 
-    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix);
+    // Без проверки границ: индексы проверяет вызывающий, один раз на цикл
+    T& operator()(size_t i, size_t j) { return _data[i * _stride + j]; }
+    const T& operator()(size_t i, size_t j) const { return _data[i * _stride + j]; }
+
+    T& at(size_t i, size_t j);
+    const T& at(size_t i, size_t j) const;
+
+    // Строка целиком; проверяется только индекс строки
+    std::span<T> row(size_t i);
+    std::span<const T> row(size_t i) const;
+
+    T* data() noexcept { return _data; }
+    const T* data() const noexcept { return _data; }
+    size_t getStride() const noexcept { return _stride; }
+
+    MatrixView<T> view() noexcept { return MatrixView<T>(_data, _n, _m, _stride); }
+    MatrixView<const T> view() const noexcept { return MatrixView<const T>(_data, _n, _m, _stride); }
+    MatrixView<T> block(size_t i0, size_t j0, size_t rows, size_t cols) { return view().block(i0, j0, rows, cols); }
+    MatrixView<const T> block(size_t i0, size_t j0, size_t rows, size_t cols) const {
+        return view().block(i0, j0, rows, cols);
+    }
+
+    T coeff(size_t i, size_t j) const { return _data[i * _stride + j]; }
+    bool aliases(const matrix_expr::Target& target) const {
+        return matrix_expr::leafAliases(target, _data, _data + _n * _stride, _stride, 1);
+    }
+
+    // Поэлементно на месте, без временной матрицы; правая часть может содержать саму матрицу
+    template<class E>
+    BasicMatrix& operator+=(const MatrixExpr<E>& expr);
+    template<class E>
+    BasicMatrix& operator-=(const MatrixExpr<E>& expr);
+
+    BasicMatrix& operator*=(T k);
+    BasicMatrix operator*(T k) const;
+    BasicMatrix operator*(const BasicMatrix& other) const;
+    BasicMatrix multiply(const BasicMatrix& other, Accumulation accumulation = Accumulation::Int32) const
+        requires std::is_same_v<T, int32_t>;
+
+    // Поэлементные операции с выбранной политикой переполнения, векторизованы и распараллелены.
+    // В режиме Checked при переполнении бросается std::overflow_error, а сама матрица не меняется
+    BasicMatrix add(const BasicMatrix& other, Overflow overflow) const
+        requires std::is_integral_v<T> && std::is_signed_v<T>;
+    BasicMatrix subtract(const BasicMatrix& other, Overflow overflow) const
+        requires std::is_integral_v<T> && std::is_signed_v<T>;
+    BasicMatrix& scale(T k, Overflow overflow)
+        requires std::is_integral_v<T> && std::is_signed_v<T>;
+
+    BasicMatrix transpose() const;
+    // Квадратная матрица транспонируется без выделения памяти, прямоугольная - через transpose()
+    void transposeInPlace();
+
+    // != синтезируется компилятором из ==
+    template<class E>
+    bool operator==(const MatrixExpr<E>& other) const;
+
+    // Двоичный формат описан в matrix_io.h; ошибки чтения и записи - std::runtime_error
+    void writeBinary(std::ostream& os) const;
+    static BasicMatrix readBinary(std::istream& is);
+    void save(const std::string& path) const;
+    static BasicMatrix load(const std::string& path);
+
+    // Файл не читается целиком: страницы подгружаются при первом обращении
+    static MappedMatrix<T> mapFile(const std::string& path);
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicMatrix& matrix) {
+        for (size_t i = 0; i < matrix._n; ++i) {
+            const T* row = matrix.rowPtr(i);
+            for (size_t j = 0; j < matrix._m; ++j) {
+                os << row[j] << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
 
 private:
+    static size_t strideFor(size_t m) noexcept;
+    static T* allocate(size_t count);
+    static void deallocate(T* data) noexcept;
+
+    template<class Fn>
+    void forEachRowBlock(Fn&& fn) const;
+
+    template<class E>
+    void assign(const E& expr);
+
+    template<class E, class Op>
+    void update(const E& expr, Op op);
+
+    template<class Kernel>
+    bool anyRowBlock(Kernel kernel) const;
+
+    static constexpr size_t kTransposeLeaf = 32;
+    static constexpr size_t kTransposeTile = 64;
+    static void transposeBlock(const T* src, size_t lds, T* dst, size_t ldd, size_t rows, size_t cols);
+    static void transposeTile(T* a, T* b, size_t ld, size_t rows, size_t cols);
+
+    bool equals(const BasicMatrix& other) const;
     void clean() noexcept;
-    void copyFrom(const Matrix& other);
+    void copyFrom(const BasicMatrix& other);
+
+    matrix_expr::Target target() const noexcept { return matrix_expr::Target{_data, _data + _n * _stride, _stride, 1}; }
 
-    ProxyRow **_rows;
+    T* rowPtr(size_t i) noexcept { return _data + i * _stride; }
+    const T* rowPtr(size_t i) const noexcept { return _data + i * _stride; }
+
+    // Строки лежат подряд в одном выровненном по 64 байта буфере, каждая дополнена нулями до _stride
+    T* _data;
     size_t _n;
     size_t _m;
+    size_t _stride;
 };
 
+// dst = a * b для произвольных видов, в том числе подматриц и транспонированных; dst перезаписывается.
+// Если dst пересекается с a или b, произведение сначала считается во временную матрицу
+template<class T>
+void multiplyInto(MatrixView<T> dst, MatrixView<const std::type_identity_t<T>> a,
+                  MatrixView<const std::type_identity_t<T>> b);
+
+template<class A, class B>
+BasicMatrix<std::remove_const_t<A>> operator*(const MatrixView<A>& a, const MatrixView<B>& b);
+
+using Matrix = BasicMatrix<int32_t>;
+
+using Matrix3f = BasicMatrix<float, 3, 3>;
+using Matrix4f = BasicMatrix<float, 4, 4>;
+using Matrix3d = BasicMatrix<double, 3, 3>;
+using Matrix4d = BasicMatrix<double, 4, 4>;
+
+#include "matrix.hpp"
+
 #endif
@@ -0,0 +1,661 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include "matrix_gemm.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <vector>
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, R, C>::BasicMatrix(std::initializer_list<std::initializer_list<T>> rows) {
+    if (rows.size() != R) throw std::invalid_argument("Wrong number of rows");
+    size_t i = 0;
+    for (const auto& row : rows) {
+        if (row.size() != C) throw std::invalid_argument("Wrong number of columns");
+        std::copy(row.begin(), row.end(), _data.begin() + i * C);
+        ++i;
+    }
+}
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, R, C> BasicMatrix<T, R, C>::identity() {
+    static_assert(R == C, "Identity matrix must be square");
+    BasicMatrix res;
+    unroll([&res](size_t i) { res._data[i * C + i] = T(1); }, std::make_index_sequence<R>());
+    return res;
+}
+
+template<class T, size_t R, size_t C>
+constexpr T& BasicMatrix<T, R, C>::at(size_t i, size_t j) {
+    if (i >= R) throw std::out_of_range("Row index out of range");
+    if (j >= C) throw std::out_of_range("Column index out of range");
+    return _data[i * C + j];
+}
+
+template<class T, size_t R, size_t C>
+constexpr const T& BasicMatrix<T, R, C>::at(size_t i, size_t j) const {
+    if (i >= R) throw std::out_of_range("Row index out of range");
+    if (j >= C) throw std::out_of_range("Column index out of range");
+    return _data[i * C + j];
+}
+
+template<class T, size_t R, size_t C>
+constexpr std::span<T, C> BasicMatrix<T, R, C>::row(size_t i) {
+    if (i >= R) throw std::out_of_range("Row index out of range");
+    return std::span<T, C>(_data.data() + i * C, C);
+}
+
+template<class T, size_t R, size_t C>
+constexpr std::span<const T, C> BasicMatrix<T, R, C>::row(size_t i) const {
+    if (i >= R) throw std::out_of_range("Row index out of range");
+    return std::span<const T, C>(_data.data() + i * C, C);
+}
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, R, C>& BasicMatrix<T, R, C>::operator+=(const BasicMatrix& other) {
+    unroll([this, &other](size_t k) { _data[k] = matrix_expr::wrapAdd(_data[k], other._data[k]); },
+           std::make_index_sequence<R * C>());
+    return *this;
+}
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, R, C>& BasicMatrix<T, R, C>::operator-=(const BasicMatrix& other) {
+    unroll([this, &other](size_t k) { _data[k] = matrix_expr::wrapSub(_data[k], other._data[k]); },
+           std::make_index_sequence<R * C>());
+    return *this;
+}
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, R, C>& BasicMatrix<T, R, C>::operator*=(T k) {
+    unroll([this, k](size_t idx) { _data[idx] = matrix_expr::wrapMul(_data[idx], k); },
+           std::make_index_sequence<R * C>());
+    return *this;
+}
+
+// Каждый элемент результата - развёрнутая свёртка по C слагаемым
+template<class T, size_t R, size_t C>
+template<size_t K>
+constexpr BasicMatrix<T, R, K> BasicMatrix<T, R, C>::operator*(const BasicMatrix<T, C, K>& other) const {
+    BasicMatrix<T, R, K> res;
+    unroll([this, &other, &res](size_t idx) {
+        size_t i = idx / K;
+        size_t j = idx % K;
+        T sum = T(0);
+        unroll([this, &other, &sum, i, j](size_t p) {
+            sum = matrix_expr::wrapAdd(sum, matrix_expr::wrapMul((*this)(i, p), other(p, j)));
+        }, std::make_index_sequence<C>());
+        res(i, j) = sum;
+    }, std::make_index_sequence<R * K>());
+    return res;
+}
+
+template<class T, size_t R, size_t C>
+constexpr BasicMatrix<T, C, R> BasicMatrix<T, R, C>::transpose() const {
+    BasicMatrix<T, C, R> res;
+    unroll([this, &res](size_t idx) { res(idx % C, idx / C) = _data[idx]; }, std::make_index_sequence<R * C>());
+    return res;
+}
+
+template<class T, size_t R, size_t C>
+constexpr void BasicMatrix<T, R, C>::transposeInPlace() requires (R == C) {
+    unroll([this](size_t idx) {
+        size_t i = idx / C;
+        size_t j = idx % C;
+        if (i < j) std::swap(_data[idx], _data[j * C + i]);
+    }, std::make_index_sequence<R * C>());
+}
+
+template<class T>
+size_t BasicMatrix<T>::strideFor(size_t m) noexcept {
+    const size_t per_line = kAlignment / sizeof(T);
+    return (m + per_line - 1) / per_line * per_line;
+}
+
+template<class T>
+T* BasicMatrix<T>::allocate(size_t count) {
+    if (count == 0) return nullptr;
+    void* ptr = ::operator new[](count * sizeof(T), std::align_val_t(kAlignment));
+    std::memset(ptr, 0, count * sizeof(T));
+    return static_cast<T*>(ptr);
+}
+
+template<class T>
+void BasicMatrix<T>::deallocate(T* data) noexcept {
+    if (data) ::operator delete[](data, std::align_val_t(kAlignment));
+}
+
+template<class T>
+void BasicMatrix<T>::clean() noexcept {
+    deallocate(_data);
+    _data = nullptr;
+    _n = 0;
+    _m = 0;
+    _stride = 0;
+}
+
+template<class T>
+void BasicMatrix<T>::copyFrom(const BasicMatrix& other) {
+    T* data = allocate(other._n * other._stride);
+    if (data) std::memcpy(data, other._data, other._n * other._stride * sizeof(T));
+    _data = data;
+    _n = other._n;
+    _m = other._m;
+    _stride = other._stride;
+}
+
+template<class T>
+BasicMatrix<T>::BasicMatrix(size_t n, size_t m)
+    : _data(nullptr), _n(n), _m(m), _stride(strideFor(m)) {
+    if (n > 0 && m > 0)
+        _data = allocate(_n * _stride);
+}
+
+template<class T>
+BasicMatrix<T>::BasicMatrix(const BasicMatrix& other)
+    : _data(nullptr), _n(0), _m(0), _stride(0) {
+    copyFrom(other);
+}
+
+template<class T>
+BasicMatrix<T>::BasicMatrix(BasicMatrix&& other) noexcept
+    : _data(other._data), _n(other._n), _m(other._m), _stride(other._stride) {
+    other._data = nullptr;
+    other._n = 0;
+    other._m = 0;
+    other._stride = 0;
+}
+
+template<class T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const BasicMatrix& other) {
+    if (this != &other) {
+        if (_n * _stride == other._n * other._stride && _data) {
+            std::memcpy(_data, other._data, other._n * other._stride * sizeof(T));
+            _n = other._n;
+            _m = other._m;
+            _stride = other._stride;
+        } else {
+            BasicMatrix copy(other);
+            *this = std::move(copy);
+        }
+    }
+    return *this;
+}
+
+template<class T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(BasicMatrix&& other) noexcept {
+    if (this != &other) {
+        clean();
+        _data = other._data;
+        _n = other._n;
+        _m = other._m;
+        _stride = other._stride;
+        other._data = nullptr;
+        other._n = 0;
+        other._m = 0;
+        other._stride = 0;
+    }
+    return *this;
+}
+
+template<class T>
+BasicMatrix<T>::~BasicMatrix() {
+    clean();
+}
+
+template<class T>
+typename BasicMatrix<T>::ProxyRow BasicMatrix<T>::operator[](size_t i) {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return ProxyRow(rowPtr(i), _m);
+}
+
+template<class T>
+typename BasicMatrix<T>::ConstProxyRow BasicMatrix<T>::operator[](size_t i) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return ConstProxyRow(rowPtr(i), _m);
+}
+
+template<class T>
+T& BasicMatrix<T>::at(size_t i, size_t j) {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    if (j >= _m) throw std::out_of_range("Column index out of range");
+    return _data[i * _stride + j];
+}
+
+template<class T>
+const T& BasicMatrix<T>::at(size_t i, size_t j) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    if (j >= _m) throw std::out_of_range("Column index out of range");
+    return _data[i * _stride + j];
+}
+
+template<class T>
+std::span<T> BasicMatrix<T>::row(size_t i) {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return std::span<T>(rowPtr(i), _m);
+}
+
+template<class T>
+std::span<const T> BasicMatrix<T>::row(size_t i) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return std::span<const T>(rowPtr(i), _m);
+}
+
+template<class T>
+template<class Fn>
+void BasicMatrix<T>::forEachRowBlock(Fn&& fn) const {
+    if (_n * _m < kParallelThreshold) {
+        fn(size_t(0), _n);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, kParallelThreshold / 2 / std::max<size_t>(_m, 1));
+    ThreadPool::global().parallelFor(0, _n, grain, fn);
+}
+
+template<class T>
+template<class E>
+void BasicMatrix<T>::assign(const E& expr) {
+    forEachRowBlock([this, &expr](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = rowPtr(i);
+            for (size_t j = 0; j < _m; ++j)
+                row[j] = expr.coeff(i, j);
+        }
+    });
+}
+
+template<class T>
+template<class E>
+BasicMatrix<T>::BasicMatrix(const MatrixExpr<E>& expr)
+    : BasicMatrix(expr.getRows(), expr.getCols()) {
+    static_assert(std::is_same_v<typename E::value_type, T>, "Element types differ");
+    assign(expr.self());
+}
+
+// Узлы выражений поэлементные, поэтому сама матрица может входить в правую часть: её элемент читается
+// в той же позиции, в которую пишется. Если же выражение читает эту память иначе (транспонированный вид,
+// сдвинутый блок), оно сначала вычисляется во временную матрицу
+template<class T>
+template<class E>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const MatrixExpr<E>& expr) {
+    static_assert(std::is_same_v<typename E::value_type, T>, "Element types differ");
+    if (_n == expr.getRows() && _m == expr.getCols() && !expr.self().aliases(target()))
+        assign(expr.self());
+    else *this = BasicMatrix(expr);
+    return *this;
+}
+
+template<class T>
+template<class E, class Op>
+void BasicMatrix<T>::update(const E& expr, Op op) {
+    static_assert(std::is_same_v<typename E::value_type, T>, "Element types differ");
+    if (_n != expr.getRows() || _m != expr.getCols()) throw std::invalid_argument("Different dimensions");
+    if (expr.aliases(target())) {
+        update(BasicMatrix(expr), op);
+        return;
+    }
+    forEachRowBlock([this, &expr, op](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = rowPtr(i);
+            for (size_t j = 0; j < _m; ++j)
+                row[j] = op(row[j], expr.coeff(i, j));
+        }
+    });
+}
+
+template<class T>
+template<class E>
+BasicMatrix<T>& BasicMatrix<T>::operator+=(const MatrixExpr<E>& expr) {
+    update(expr.self(), matrix_expr::Add());
+    return *this;
+}
+
+template<class T>
+template<class E>
+BasicMatrix<T>& BasicMatrix<T>::operator-=(const MatrixExpr<E>& expr) {
+    update(expr.self(), matrix_expr::Sub());
+    return *this;
+}
+
+template<class T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(T k) {
+    forEachRowBlock([this, k](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = rowPtr(i);
+            for (size_t j = 0; j < _m; ++j)
+                row[j] = matrix_expr::wrapMul(row[j], k);
+        }
+    });
+    return *this;
+}
+
+// Ядро получает непрерывный кусок буфера строк [lo, hi) вместе с дополнением: дополнение заполнено нулями,
+// а операции над нулями не переполняются. Признаки кусков сводятся одним атомарным ИЛИ на кусок
+template<class T>
+template<class Kernel>
+bool BasicMatrix<T>::anyRowBlock(Kernel kernel) const {
+    std::atomic<bool> overflowed(false);
+    forEachRowBlock([this, &kernel, &overflowed](size_t lo, size_t hi) {
+        if (kernel(lo * _stride, (hi - lo) * _stride)) overflowed.store(true, std::memory_order_relaxed);
+    });
+    return overflowed.load();
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::add(const BasicMatrix& other, Overflow overflow) const
+    requires std::is_integral_v<T> && std::is_signed_v<T> {
+    if (_n != other._n || _m != other._m) throw std::invalid_argument("Different dimensions");
+    BasicMatrix res(_n, _m);
+    bool overflowed = anyRowBlock([&](size_t offset, size_t count) {
+        return overflow_kernel::add(_data + offset, other._data + offset, res._data + offset, count,
+                             overflow == Overflow::Saturate);
+    });
+    if (overflowed && overflow == Overflow::Checked) throw std::overflow_error("Matrix addition overflows");
+    return res;
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::subtract(const BasicMatrix& other, Overflow overflow) const
+    requires std::is_integral_v<T> && std::is_signed_v<T> {
+    if (_n != other._n || _m != other._m) throw std::invalid_argument("Different dimensions");
+    BasicMatrix res(_n, _m);
+    bool overflowed = anyRowBlock([&](size_t offset, size_t count) {
+        return overflow_kernel::sub(_data + offset, other._data + offset, res._data + offset, count,
+                             overflow == Overflow::Saturate);
+    });
+    if (overflowed && overflow == Overflow::Checked) throw std::overflow_error("Matrix subtraction overflows");
+    return res;
+}
+
+// В режиме Checked результат пишется во временный буфер, чтобы при исключении матрица осталась прежней
+template<class T>
+BasicMatrix<T>& BasicMatrix<T>::scale(T k, Overflow overflow)
+    requires std::is_integral_v<T> && std::is_signed_v<T> {
+    if (overflow == Overflow::Checked) {
+        BasicMatrix res(_n, _m);
+        bool overflowed = anyRowBlock([&](size_t offset, size_t count) {
+            return overflow_kernel::scale(_data + offset, k, res._data + offset, count, false);
+        });
+        if (overflowed) throw std::overflow_error("Matrix scaling overflows");
+        return *this = std::move(res);
+    }
+    anyRowBlock([&](size_t offset, size_t count) {
+        return overflow_kernel::scale(_data + offset, k, _data + offset, count, overflow == Overflow::Saturate);
+    });
+    return *this;
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::operator*(T k) const {
+    return BasicMatrix(ScaleExpr<BasicMatrix>(*this, k));
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::operator*(const BasicMatrix& other) const {
+    if constexpr (std::is_same_v<T, int32_t>) {
+        return multiply(other);
+    } else {
+        if (_m != other._n) throw std::invalid_argument("Incompatible dimensions");
+        BasicMatrix res(_n, other._m);
+        multiplyInto(res.view(), view(), other.view());
+        return res;
+    }
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::multiply(const BasicMatrix& other, Accumulation accumulation) const
+    requires std::is_same_v<T, int32_t> {
+    if (_m != other._n) throw std::invalid_argument("Incompatible dimensions");
+
+    BasicMatrix res(_n, other._m);
+    gemm::Operand a{_data, _stride, 1};
+    gemm::Operand b{other._data, other._stride, 1};
+    if (accumulation == Accumulation::Int32) {
+        gemm::multiply(_n, _m, other._m, a, b, res._data, res._stride);
+        return res;
+    }
+
+    std::vector<int64_t> wide(_n * other._m);
+    gemm::multiplyWide(_n, _m, other._m, a, b, wide.data(), other._m);
+    for (size_t i = 0; i < res._n; ++i) {
+        int32_t* row = res.rowPtr(i);
+        const int64_t* src = wide.data() + i * res._m;
+        for (size_t j = 0; j < res._m; ++j) {
+            if (src[j] < std::numeric_limits<int32_t>::min() || src[j] > std::numeric_limits<int32_t>::max())
+                throw std::overflow_error("Matrix product overflows int32_t");
+            row[j] = static_cast<int32_t>(src[j]);
+        }
+    }
+    return res;
+}
+
+// Рекурсивно делит больший из размеров пополам, пока блок не станет достаточно мал: на каждом уровне
+// иерархии кэшей найдётся уровень рекурсии, где строки источника и приёмника помещаются в кэш
+template<class T>
+void BasicMatrix<T>::transposeBlock(const T* src, size_t lds, T* dst, size_t ldd, size_t rows, size_t cols) {
+    if (rows <= kTransposeLeaf && cols <= kTransposeLeaf) {
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = 0; j < cols; ++j)
+                dst[j * ldd + i] = src[i * lds + j];
+        return;
+    }
+    if (rows >= cols) {
+        size_t half = rows / 2;
+        transposeBlock(src, lds, dst, ldd, half, cols);
+        transposeBlock(src + half * lds, lds, dst + half, ldd, rows - half, cols);
+    } else {
+        size_t half = cols / 2;
+        transposeBlock(src, lds, dst, ldd, rows, half);
+        transposeBlock(src + half, lds, dst + half * ldd, ldd, rows, cols - half);
+    }
+}
+
+// Меняет местами плитку a (rows x cols) с транспонированной плиткой b; при a == b транспонирует
+// квадратную плитку на диагонали
+template<class T>
+void BasicMatrix<T>::transposeTile(T* a, T* b, size_t ld, size_t rows, size_t cols) {
+    if (a == b) {
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = i + 1; j < cols; ++j)
+                std::swap(a[i * ld + j], a[j * ld + i]);
+        return;
+    }
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            std::swap(a[i * ld + j], b[j * ld + i]);
+}
+
+// Строка результата i - это столбец i источника, поэтому потоки делят между собой столбцы
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const {
+    BasicMatrix res(_m, _n);
+    res.forEachRowBlock([this, &res](size_t lo, size_t hi) {
+        transposeBlock(_data + lo, _stride, res.rowPtr(lo), res._stride, _n, hi - lo);
+    });
+    return res;
+}
+
+// Поток, взявший полосу плиток bi, обменивает плитки (bi, bj) и (bj, bi) при bj > bi, так что
+// каждая пара принадлежит ровно одной полосе
+template<class T>
+void BasicMatrix<T>::transposeInPlace() {
+    if (_n != _m) {
+        *this = transpose();
+        return;
+    }
+    const size_t tiles = (_n + kTransposeTile - 1) / kTransposeTile;
+    auto strip = [this, tiles](size_t lo, size_t hi) {
+        for (size_t bi = lo; bi < hi; ++bi) {
+            size_t i0 = bi * kTransposeTile;
+            size_t rows = std::min(kTransposeTile, _n - i0);
+            for (size_t bj = bi; bj < tiles; ++bj) {
+                size_t j0 = bj * kTransposeTile;
+                size_t cols = std::min(kTransposeTile, _n - j0);
+                transposeTile(rowPtr(i0) + j0, rowPtr(j0) + i0, _stride, rows, cols);
+            }
+        }
+    };
+    if (_n * _n < kParallelThreshold) strip(0, tiles);
+    else ThreadPool::global().parallelFor(0, tiles, 1, strip);
+}
+
+// Член-шаблон точнее свободного operator== из matrix_expr.h и в прямом, и в переставленном виде,
+// поэтому сравнение матрицы с выражением однозначно
+template<class T>
+template<class E>
+bool BasicMatrix<T>::operator==(const MatrixExpr<E>& other) const {
+    if constexpr (std::is_same_v<E, BasicMatrix>) {
+        return equals(other.self());
+    } else {
+        return static_cast<const MatrixExpr<BasicMatrix>&>(*this) == other;
+    }
+}
+
+// Целые сравниваются побайтно, у чисел с плавающей точкой +0 == -0 и NaN != NaN
+template<class T>
+bool BasicMatrix<T>::equals(const BasicMatrix& other) const {
+    if (_n != other._n || _m != other._m) return false;
+
+    for (size_t i = 0; i < _n; ++i) {
+        if constexpr (std::is_integral_v<T>) {
+            if (std::memcmp(rowPtr(i), other.rowPtr(i), _m * sizeof(T)) != 0)
+                return false;
+        } else {
+            if (!std::equal(rowPtr(i), rowPtr(i) + _m, other.rowPtr(i)))
+                return false;
+        }
+    }
+    return true;
+}
+
+template<class T>
+void BasicMatrix<T>::writeBinary(std::ostream& os) const {
+    matrix_io::Header header = matrix_io::makeHeader(matrix_io::dtypeOf<T>(), _n, _m, _stride);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (_data) os.write(reinterpret_cast<const char*>(_data), _n * _stride * sizeof(T));
+    if (!os) throw std::runtime_error("Failed to write matrix");
+}
+
+// Если шаг строк в файле совпадает со своим, данные читаются одним куском
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::readBinary(std::istream& is) {
+    matrix_io::Header header;
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("Matrix stream is truncated");
+    matrix_io::checkHeader(header, matrix_io::dtypeOf<T>(), sizeof(T));
+
+    BasicMatrix res(header.rows, header.cols);
+    if (header.stride == res._stride) {
+        if (res._data) is.read(reinterpret_cast<char*>(res._data), res._n * res._stride * sizeof(T));
+    } else {
+        for (size_t i = 0; i < res._n && is; ++i) {
+            is.read(reinterpret_cast<char*>(res.rowPtr(i)), res._m * sizeof(T));
+            is.ignore((header.stride - header.cols) * sizeof(T));
+        }
+    }
+    if (!is) throw std::runtime_error("Matrix stream is truncated");
+    return res;
+}
+
+template<class T>
+void BasicMatrix<T>::save(const std::string& path) const {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os) throw std::runtime_error("Cannot open " + path);
+    writeBinary(os);
+}
+
+template<class T>
+BasicMatrix<T> BasicMatrix<T>::load(const std::string& path) {
+    std::ifstream is(path, std::ios::binary);
+    if (!is) throw std::runtime_error("Cannot open " + path);
+    return readBinary(is);
+}
+
+template<class T>
+MappedMatrix<T> BasicMatrix<T>::mapFile(const std::string& path) {
+    return MappedMatrix<T>(path);
+}
+
+// Для int32_t при единичном шаге столбцов dst работает упакованное ядро, которое само принимает шаги a и b.
+// Иначе строка результата накапливается порядком i-k-j, k режется на блоки, чтобы они жили в кэше;
+// при единичных шагах столбцов внутренний цикл идёт подряд по памяти и векторизуется компилятором
+template<class T>
+void multiplyInto(MatrixView<T> dst, MatrixView<const std::type_identity_t<T>> a,
+                  MatrixView<const std::type_identity_t<T>> b) {
+    static_assert(!std::is_const_v<T>, "Cannot write through a read-only view");
+    const size_t n = a.getRows(), k = a.getCols(), m = b.getCols();
+    if (k != b.getRows()) throw std::invalid_argument("Incompatible dimensions");
+    if (dst.getRows() != n || dst.getCols() != m) throw std::invalid_argument("Different dimensions");
+    if (n == 0 || m == 0) return;
+
+    const T* dst_end = &dst(n - 1, m - 1) + 1;
+    if (a.overlaps(dst.data(), dst_end) || b.overlaps(dst.data(), dst_end)) {
+        BasicMatrix<T> tmp(n, m);
+        multiplyInto(tmp.view(), a, b);
+        dst = tmp;
+        return;
+    }
+
+    if constexpr (std::is_same_v<T, int32_t>) {
+        if (dst.getColStride() == 1) {
+            gemm::Operand ga{a.data(), a.getRowStride(), a.getColStride()};
+            gemm::Operand gb{b.data(), b.getRowStride(), b.getColStride()};
+            gemm::multiply(n, k, m, ga, gb, dst.data(), dst.getRowStride());
+            return;
+        }
+    }
+
+    constexpr size_t kBlock = 256;
+    auto rows = [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i)
+            for (size_t j = 0; j < m; ++j)
+                dst(i, j) = T(0);
+        const bool contiguous = dst.getColStride() == 1 && b.getColStride() == 1;
+        for (size_t p0 = 0; p0 < k; p0 += kBlock) {
+            size_t p1 = std::min(k, p0 + kBlock);
+            for (size_t i = lo; i < hi; ++i) {
+                T* c = &dst(i, 0);
+                for (size_t p = p0; p < p1; ++p) {
+                    const T aip = a(i, p);
+                    const T* row = &b(p, 0);
+                    if (contiguous) {
+                        for (size_t j = 0; j < m; ++j)
+                            c[j] = matrix_expr::wrapAdd(c[j], matrix_expr::wrapMul(aip, row[j]));
+                    } else {
+                        for (size_t j = 0; j < m; ++j) {
+                            T& cell = c[j * dst.getColStride()];
+                            cell = matrix_expr::wrapAdd(cell, matrix_expr::wrapMul(aip, row[j * b.getColStride()]));
+                        }
+                    }
+                }
+            }
+        }
+    };
+    if (n * m * std::max<size_t>(k, 1) < MatrixView<T>::kParallelThreshold) {
+        rows(0, n);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, MatrixView<T>::kParallelThreshold / 2 / (m * std::max<size_t>(k, 1)));
+    ThreadPool::global().parallelFor(0, n, grain, rows);
+}
+
+template<class A, class B>
+BasicMatrix<std::remove_const_t<A>> operator*(const MatrixView<A>& a, const MatrixView<B>& b) {
+    using T = std::remove_const_t<A>;
+    static_assert(std::is_same_v<T, std::remove_const_t<B>>, "Element types differ");
+    if (a.getCols() != b.getRows()) throw std::invalid_argument("Incompatible dimensions");
+    BasicMatrix<T> res(a.getRows(), b.getCols());
+    multiplyInto<T>(res.view(), a, b);
+    return res;
+}
+
+// Ходовые типы инстанцируются один раз в matrix.cpp
+extern template class BasicMatrix<int32_t>;
+extern template class BasicMatrix<int64_t>;
+extern template class BasicMatrix<float>;
+extern template class BasicMatrix<double>;
+
+#endif
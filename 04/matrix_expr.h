@@ -0,0 +1,223 @@
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <iostream>
+#include <span>
+#include <type_traits>
+
+// Размеры, равные std::dynamic_extent, задаются во время выполнения, иначе - на этапе компиляции
+template<class T, size_t R = std::dynamic_extent, size_t C = std::dynamic_extent>
+class BasicMatrix;
+
+namespace matrix_expr {
+
+// Куда пишется результат: элемент (i, j) лежит в data[i * row_stride + j * col_stride], вся запись - в [data, end)
+struct Target {
+    const void* data;
+    const void* end;
+    size_t row_stride;
+    size_t col_stride;
+};
+
+inline bool overlaps(const void* a_begin, const void* a_end, const void* b_begin, const void* b_end) {
+    return reinterpret_cast<uintptr_t>(a_begin) < reinterpret_cast<uintptr_t>(b_end) &&
+           reinterpret_cast<uintptr_t>(b_begin) < reinterpret_cast<uintptr_t>(a_end);
+}
+
+// Лист с раскладкой (data, row_stride, col_stride) в памяти [data, end) можно читать прямо во время записи,
+// если он не пересекается с целью или каждый его элемент лежит ровно там, куда пишется элемент результата
+inline bool leafAliases(const Target& target, const void* data, const void* end, size_t row_stride, size_t col_stride) {
+    if (!overlaps(target.data, target.end, data, end)) return false;
+    return data != target.data || row_stride != target.row_stride || col_stride != target.col_stride;
+}
+
+}
+
+// lazyAdd, lazySub и lazyScale строят дерево выражения, которое вычисляется одним проходом
+// только при присваивании в Matrix. Размеры проверяются сразу при построении узла.
+// Каждый узел и лист реализует aliases(const matrix_expr::Target&): может ли выражение читать память цели
+// не в той же позиции, в которую пишется результат. Тогда выражение вычисляется через временную матрицу
+template<class E>
+class MatrixExpr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    size_t getRows() const { return self().getRows(); }
+    size_t getCols() const { return self().getCols(); }
+};
+
+namespace matrix_expr {
+
+// Листья-матрицы хранятся по ссылке, промежуточные узлы - по значению
+template<class E>
+struct Storage {
+    using type = const E;
+};
+
+template<class T>
+struct Storage<BasicMatrix<T>> {
+    using type = const BasicMatrix<T>&;
+};
+
+// Целые считаются в беззнаковом типе не уже unsigned int: переполнение заворачивается, а не даёт UB
+template<class T>
+using Unsigned = std::make_unsigned_t<std::common_type_t<T, int>>;
+
+template<class T>
+constexpr T wrapAdd(T a, T b) {
+    if constexpr (std::is_integral_v<T>) return static_cast<T>(static_cast<Unsigned<T>>(a) + static_cast<Unsigned<T>>(b));
+    else return a + b;
+}
+
+template<class T>
+constexpr T wrapSub(T a, T b) {
+    if constexpr (std::is_integral_v<T>) return static_cast<T>(static_cast<Unsigned<T>>(a) - static_cast<Unsigned<T>>(b));
+    else return a - b;
+}
+
+template<class T>
+constexpr T wrapMul(T a, T b) {
+    if constexpr (std::is_integral_v<T>) return static_cast<T>(static_cast<Unsigned<T>>(a) * static_cast<Unsigned<T>>(b));
+    else return a * b;
+}
+
+struct Add {
+    template<class T>
+    constexpr T operator()(T a, T b) const { return wrapAdd(a, b); }
+};
+
+struct Sub {
+    template<class T>
+    constexpr T operator()(T a, T b) const { return wrapSub(a, b); }
+};
+
+}
+
+template<class L, class R, class Op>
+class BinaryExpr : public MatrixExpr<BinaryExpr<L, R, Op>> {
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "Element types differ");
+
+    typename matrix_expr::Storage<L>::type _lhs;
+    typename matrix_expr::Storage<R>::type _rhs;
+public:
+    using value_type = typename L::value_type;
+
+    BinaryExpr(const L& lhs, const R& rhs) : _lhs(lhs), _rhs(rhs) {
+        if (lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols())
+            throw std::invalid_argument("Different dimensions");
+    }
+
+    size_t getRows() const { return _lhs.getRows(); }
+    size_t getCols() const { return _lhs.getCols(); }
+
+    value_type coeff(size_t i, size_t j) const { return Op()(_lhs.coeff(i, j), _rhs.coeff(i, j)); }
+
+    bool aliases(const matrix_expr::Target& target) const { return _lhs.aliases(target) || _rhs.aliases(target); }
+};
+
+template<class E>
+class ScaleExpr : public MatrixExpr<ScaleExpr<E>> {
+public:
+    using value_type = typename E::value_type;
+
+private:
+    typename matrix_expr::Storage<E>::type _expr;
+    value_type _k;
+
+public:
+    ScaleExpr(const E& expr, value_type k) : _expr(expr), _k(k) {}
+
+    size_t getRows() const { return _expr.getRows(); }
+    size_t getCols() const { return _expr.getCols(); }
+
+    value_type coeff(size_t i, size_t j) const { return matrix_expr::wrapMul(_expr.coeff(i, j), _k); }
+
+    bool aliases(const matrix_expr::Target& target) const { return _expr.aliases(target); }
+};
+
+template<class L, class R>
+using AddExpr = BinaryExpr<L, R, matrix_expr::Add>;
+
+template<class L, class R>
+using SubExpr = BinaryExpr<L, R, matrix_expr::Sub>;
+
+namespace matrix_expr {
+
+template<class E>
+concept Expression = std::is_base_of_v<MatrixExpr<std::remove_cvref_t<E>>, std::remove_cvref_t<E>>;
+
+// Листья хранятся по ссылке, поэтому временный лист повис бы сразу после построения узла
+template<class E>
+concept Operand = Expression<E> &&
+    (std::is_lvalue_reference_v<E> || !std::is_reference_v<typename Storage<std::remove_cvref_t<E>>::type>);
+
+}
+
+// Ленивые операции: возвращают узел выражения, который вычисляется одним проходом при присваивании
+// в матрицу или вид. Узел ссылается на матрицы-листья, поэтому они должны пережить выражение
+template<class L, class R>
+    requires matrix_expr::Operand<L> && matrix_expr::Operand<R>
+AddExpr<std::remove_cvref_t<L>, std::remove_cvref_t<R>> lazyAdd(L&& lhs, R&& rhs) {
+    return AddExpr<std::remove_cvref_t<L>, std::remove_cvref_t<R>>(lhs, rhs);
+}
+
+template<class L, class R>
+    requires matrix_expr::Operand<L> && matrix_expr::Operand<R>
+SubExpr<std::remove_cvref_t<L>, std::remove_cvref_t<R>> lazySub(L&& lhs, R&& rhs) {
+    return SubExpr<std::remove_cvref_t<L>, std::remove_cvref_t<R>>(lhs, rhs);
+}
+
+template<class E>
+    requires matrix_expr::Operand<E>
+ScaleExpr<std::remove_cvref_t<E>> lazyScale(E&& expr, typename std::remove_cvref_t<E>::value_type k) {
+    return ScaleExpr<std::remove_cvref_t<E>>(expr, k);
+}
+
+// Обычные операции сразу возвращают матрицу: результат можно индексировать, менять и хранить в auto
+template<class L, class R>
+BasicMatrix<typename L::value_type> operator+(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return BasicMatrix<typename L::value_type>(AddExpr<L, R>(lhs.self(), rhs.self()));
+}
+
+template<class L, class R>
+BasicMatrix<typename L::value_type> operator-(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return BasicMatrix<typename L::value_type>(SubExpr<L, R>(lhs.self(), rhs.self()));
+}
+
+template<class E>
+BasicMatrix<typename E::value_type> operator*(const MatrixExpr<E>& expr, typename E::value_type k) {
+    return BasicMatrix<typename E::value_type>(ScaleExpr<E>(expr.self(), k));
+}
+
+template<class E>
+BasicMatrix<typename E::value_type> operator*(typename E::value_type k, const MatrixExpr<E>& expr) {
+    return BasicMatrix<typename E::value_type>(ScaleExpr<E>(expr.self(), k));
+}
+
+template<class L, class R>
+bool operator==(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    const L& l = lhs.self();
+    const R& r = rhs.self();
+    if (l.getRows() != r.getRows() || l.getCols() != r.getCols()) return false;
+    for (size_t i = 0; i < l.getRows(); ++i)
+        for (size_t j = 0; j < l.getCols(); ++j)
+            if (l.coeff(i, j) != r.coeff(i, j)) return false;
+    return true;
+}
+
+template<class E>
+std::ostream& operator<<(std::ostream& os, const MatrixExpr<E>& expr) {
+    const E& e = expr.self();
+    for (size_t i = 0; i < e.getRows(); ++i) {
+        for (size_t j = 0; j < e.getCols(); ++j) {
+            os << e.coeff(i, j) << " ";
+        }
+        os << std::endl;
+    }
+    return os;
+}
+
+#endif
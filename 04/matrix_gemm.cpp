@@ -0,0 +1,230 @@
+#include "matrix_gemm.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <immintrin.h>
+
+namespace gemm {
+namespace {
+
+// Микроядро считает блок MR x NR, панели A и B упаковываются так, чтобы ядро читало их подряд.
+// Размеры блоков подобраны так, чтобы блок A (MC x KC) помещался в L2, а панель B (KC x NC) - в L3
+constexpr size_t MR = 4;
+constexpr size_t NR = 16;
+constexpr size_t KC = 256;
+constexpr size_t MC = 128;
+constexpr size_t NC = 2048;
+// Меньшие произведения (в умножениях-сложениях) считаются в вызывающем потоке
+constexpr size_t kParallelWork = size_t(1) << 21;
+
+void packA(const Operand& a, size_t i0, size_t p0, size_t mc, size_t kc, int32_t* dst) {
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        size_t rows = std::min(MR, mc - ir);
+        const int32_t* src = a.data + (i0 + ir) * a.row_stride + p0 * a.col_stride;
+        for (size_t p = 0; p < kc; ++p) {
+            size_t r = 0;
+            for (; r < rows; ++r)
+                *dst++ = src[r * a.row_stride + p * a.col_stride];
+            for (; r < MR; ++r)
+                *dst++ = 0;
+        }
+    }
+}
+
+void packB(const Operand& b, size_t p0, size_t j0, size_t kc, size_t nc, int32_t* dst) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t cols = std::min(NR, nc - jr);
+        const int32_t* src = b.data + p0 * b.row_stride + (j0 + jr) * b.col_stride;
+        for (size_t p = 0; p < kc; ++p, dst += NR) {
+            const int32_t* row = src + p * b.row_stride;
+            if (cols == NR && b.col_stride == 1) {
+                std::memcpy(dst, row, NR * sizeof(int32_t));
+                continue;
+            }
+            size_t c = 0;
+            for (; c < cols; ++c)
+                dst[c] = row[c * b.col_stride];
+            for (; c < NR; ++c)
+                dst[c] = 0;
+        }
+    }
+}
+
+void kernelScalar(size_t kc, const int32_t* a, const int32_t* b, int32_t* c, size_t ldc, size_t mr, size_t nr) {
+    uint32_t acc[MR][NR] = {};
+    for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+        for (size_t r = 0; r < MR; ++r) {
+            uint32_t ar = static_cast<uint32_t>(a[r]);
+            for (size_t j = 0; j < NR; ++j)
+                acc[r][j] += ar * static_cast<uint32_t>(b[j]);
+        }
+    for (size_t r = 0; r < mr; ++r)
+        for (size_t j = 0; j < nr; ++j)
+            c[r * ldc + j] = static_cast<int32_t>(static_cast<uint32_t>(c[r * ldc + j]) + acc[r][j]);
+}
+
+void kernelWideScalar(size_t kc, const int32_t* a, const int32_t* b, int64_t* c, size_t ldc, size_t mr, size_t nr) {
+    int64_t acc[MR][NR] = {};
+    for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+        for (size_t r = 0; r < MR; ++r)
+            for (size_t j = 0; j < NR; ++j)
+                acc[r][j] += static_cast<int64_t>(a[r]) * b[j];
+    for (size_t r = 0; r < mr; ++r)
+        for (size_t j = 0; j < nr; ++j)
+            c[r * ldc + j] += acc[r][j];
+}
+
+__attribute__((target("avx2")))
+void kernelAvx2(size_t kc, const int32_t* a, const int32_t* b, int32_t* c, size_t ldc, size_t mr, size_t nr) {
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+
+    for (size_t p = 0; p < kc; ++p, a += MR, b += NR) {
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 8));
+        __m256i a0 = _mm256_set1_epi32(a[0]);
+        __m256i a1 = _mm256_set1_epi32(a[1]);
+        __m256i a2 = _mm256_set1_epi32(a[2]);
+        __m256i a3 = _mm256_set1_epi32(a[3]);
+        c00 = _mm256_add_epi32(c00, _mm256_mullo_epi32(a0, b0));
+        c01 = _mm256_add_epi32(c01, _mm256_mullo_epi32(a0, b1));
+        c10 = _mm256_add_epi32(c10, _mm256_mullo_epi32(a1, b0));
+        c11 = _mm256_add_epi32(c11, _mm256_mullo_epi32(a1, b1));
+        c20 = _mm256_add_epi32(c20, _mm256_mullo_epi32(a2, b0));
+        c21 = _mm256_add_epi32(c21, _mm256_mullo_epi32(a2, b1));
+        c30 = _mm256_add_epi32(c30, _mm256_mullo_epi32(a3, b0));
+        c31 = _mm256_add_epi32(c31, _mm256_mullo_epi32(a3, b1));
+    }
+
+    alignas(32) int32_t tile[MR][NR];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[0]), c00);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[0] + 8), c01);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[1]), c10);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[1] + 8), c11);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[2]), c20);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[2] + 8), c21);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[3]), c30);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile[3] + 8), c31);
+
+    if (mr == MR && nr == NR) {
+        for (size_t r = 0; r < MR; ++r) {
+            __m256i* row = reinterpret_cast<__m256i*>(c + r * ldc);
+            const __m256i* t = reinterpret_cast<const __m256i*>(tile[r]);
+            _mm256_storeu_si256(row, _mm256_add_epi32(_mm256_loadu_si256(row), _mm256_load_si256(t)));
+            _mm256_storeu_si256(row + 1, _mm256_add_epi32(_mm256_loadu_si256(row + 1), _mm256_load_si256(t + 1)));
+        }
+        return;
+    }
+    for (size_t r = 0; r < mr; ++r)
+        for (size_t j = 0; j < nr; ++j)
+            c[r * ldc + j] = static_cast<int32_t>(static_cast<uint32_t>(c[r * ldc + j]) +
+                                                  static_cast<uint32_t>(tile[r][j]));
+}
+
+// _mm256_mul_epi32 перемножает младшие 32 бита 64-битных полос со знаком, поэтому B расширяется до int64
+__attribute__((target("avx2")))
+void kernelWideAvx2(size_t kc, const int32_t* a, const int32_t* b, int64_t* c, size_t ldc, size_t mr, size_t nr) {
+    alignas(32) int64_t tile[MR][NR];
+    for (size_t half = 0; half < NR; half += 8) {
+        __m256i c0l = _mm256_setzero_si256(), c0h = _mm256_setzero_si256();
+        __m256i c1l = _mm256_setzero_si256(), c1h = _mm256_setzero_si256();
+        __m256i c2l = _mm256_setzero_si256(), c2h = _mm256_setzero_si256();
+        __m256i c3l = _mm256_setzero_si256(), c3h = _mm256_setzero_si256();
+
+        const int32_t* pa = a;
+        const int32_t* pb = b + half;
+        for (size_t p = 0; p < kc; ++p, pa += MR, pb += NR) {
+            __m256i bl = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb)));
+            __m256i bh = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + 4)));
+            __m256i a0 = _mm256_set1_epi64x(pa[0]);
+            __m256i a1 = _mm256_set1_epi64x(pa[1]);
+            __m256i a2 = _mm256_set1_epi64x(pa[2]);
+            __m256i a3 = _mm256_set1_epi64x(pa[3]);
+            c0l = _mm256_add_epi64(c0l, _mm256_mul_epi32(a0, bl));
+            c0h = _mm256_add_epi64(c0h, _mm256_mul_epi32(a0, bh));
+            c1l = _mm256_add_epi64(c1l, _mm256_mul_epi32(a1, bl));
+            c1h = _mm256_add_epi64(c1h, _mm256_mul_epi32(a1, bh));
+            c2l = _mm256_add_epi64(c2l, _mm256_mul_epi32(a2, bl));
+            c2h = _mm256_add_epi64(c2h, _mm256_mul_epi32(a2, bh));
+            c3l = _mm256_add_epi64(c3l, _mm256_mul_epi32(a3, bl));
+            c3h = _mm256_add_epi64(c3h, _mm256_mul_epi32(a3, bh));
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[0] + half), c0l);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[0] + half + 4), c0h);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[1] + half), c1l);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[1] + half + 4), c1h);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[2] + half), c2l);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[2] + half + 4), c2h);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[3] + half), c3l);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tile[3] + half + 4), c3h);
+    }
+    for (size_t r = 0; r < mr; ++r)
+        for (size_t j = 0; j < nr; ++j)
+            c[r * ldc + j] += tile[r][j];
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+template<class Acc, class Kernel>
+void run(size_t n, size_t k, size_t m, Operand a, Operand b, Acc* c, size_t ldc, Kernel kernel) {
+    for (size_t i = 0; i < n; ++i)
+        std::fill(c + i * ldc, c + i * ldc + m, Acc(0));
+    if (n == 0 || m == 0 || k == 0) return;
+
+    ThreadPool& pool = ThreadPool::global();
+    bool parallel = n * m * k >= kParallelWork && pool.size() > 1;
+    size_t mc_block = MC;
+    if (parallel && (n + MC - 1) / MC < pool.size()) {
+        size_t per_thread = (n + pool.size() - 1) / pool.size();
+        mc_block = std::max(MR, (per_thread + MR - 1) / MR * MR);
+    }
+
+    size_t kc_max = std::min(KC, k);
+    std::vector<int32_t> packed_b(kc_max * ((std::min(NC, m) + NR - 1) / NR * NR));
+
+    for (size_t jc = 0; jc < m; jc += NC) {
+        size_t nc = std::min(NC, m - jc);
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            packB(b, pc, jc, kc, nc, packed_b.data());
+
+            auto blocks = [&](size_t lo, size_t hi) {
+                thread_local std::vector<int32_t> packed_a;
+                packed_a.resize(KC * mc_block);
+                for (size_t block = lo; block < hi; ++block) {
+                    size_t ic = block * mc_block;
+                    size_t mc = std::min(mc_block, n - ic);
+                    packA(a, ic, pc, mc, kc, packed_a.data());
+                    for (size_t jr = 0; jr < nc; jr += NR)
+                        for (size_t ir = 0; ir < mc; ir += MR)
+                            kernel(kc, packed_a.data() + ir * kc, packed_b.data() + jr * kc,
+                                   c + (ic + ir) * ldc + jc + jr, ldc,
+                                   std::min(MR, mc - ir), std::min(NR, nc - jr));
+                }
+            };
+            size_t block_count = (n + mc_block - 1) / mc_block;
+            if (parallel) pool.parallelFor(0, block_count, 1, blocks);
+            else blocks(0, block_count);
+        }
+    }
+}
+
+}
+
+void multiply(size_t n, size_t k, size_t m, Operand a, Operand b, int32_t* c, size_t ldc) {
+    run(n, k, m, a, b, c, ldc, hasAvx2() ? kernelAvx2 : kernelScalar);
+}
+
+void multiplyWide(size_t n, size_t k, size_t m, Operand a, Operand b, int64_t* c, size_t ldc) {
+    run(n, k, m, a, b, c, ldc, hasAvx2() ? kernelWideAvx2 : kernelWideScalar);
+}
+
+}
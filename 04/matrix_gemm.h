@@ -0,0 +1,24 @@
+#ifndef MATRIX_GEMM_H
+#define MATRIX_GEMM_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace gemm {
+
+// Элемент (i, j) операнда лежит по адресу data[i * row_stride + j * col_stride]
+struct Operand {
+    const int32_t* data;
+    size_t row_stride;
+    size_t col_stride;
+};
+
+// C (n x m, строки через ldc) = A (n x k) * B (k x m), переполнение int32 заворачивается
+void multiply(size_t n, size_t k, size_t m, Operand a, Operand b, int32_t* c, size_t ldc);
+
+// То же, но с накоплением в int64
+void multiplyWide(size_t n, size_t k, size_t m, Operand a, Operand b, int64_t* c, size_t ldc);
+
+}
+
+#endif
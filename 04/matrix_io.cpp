@@ -0,0 +1,38 @@
+#include "matrix_io.h"
+
+#include <cstring>
+#include <limits>
+
+namespace matrix_io {
+
+Header makeHeader(DType dtype, size_t rows, size_t cols, size_t stride) {
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dtype = static_cast<uint32_t>(dtype);
+    header.rows = rows;
+    header.cols = cols;
+    header.stride = stride;
+    return header;
+}
+
+size_t checkHeader(const Header& header, DType dtype, size_t elem_size) {
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Not a matrix file");
+    if (header.version != kVersion) {
+        if (header.version == __builtin_bswap32(kVersion))
+            throw std::runtime_error("Matrix file has foreign byte order");
+        throw std::runtime_error("Unsupported matrix file version");
+    }
+    if (header.dtype != static_cast<uint32_t>(dtype))
+        throw std::runtime_error("Matrix file has a different element type");
+    if (header.stride < header.cols)
+        throw std::runtime_error("Matrix file stride is smaller than its width");
+
+    const uint64_t limit = std::numeric_limits<size_t>::max() / elem_size;
+    if (header.stride != 0 && header.rows > limit / header.stride)
+        throw std::runtime_error("Matrix file dimensions are too large");
+    return static_cast<size_t>(header.rows * header.stride) * elem_size;
+}
+
+}
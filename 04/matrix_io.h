@@ -0,0 +1,126 @@
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "mapped_file.h"
+#include "matrix_expr.h"
+#include "matrix_view.h"
+
+// Двоичный формат матрицы: заголовок Header (64 байта), затем rows * stride элементов в порядке байтов
+// машины. Строки дополнены до stride, так что данные лежат так же, как в памяти BasicMatrix, и
+// после mmap с выравниванием по странице каждая строка остаётся выровненной по 64 байта
+namespace matrix_io {
+
+enum class DType : uint32_t { Int32 = 1, Int64 = 2, Float32 = 3, Float64 = 4 };
+
+inline constexpr char kMagic[8] = {'V', 'K', 'M', 'A', 'T', 'R', 'I', 'X'};
+inline constexpr uint32_t kVersion = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t dtype;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t stride;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(Header) == 64, "Header must keep the payload 64-byte aligned");
+
+template<class T>
+constexpr DType dtypeOf() {
+    if constexpr (std::is_same_v<T, int32_t>) return DType::Int32;
+    else if constexpr (std::is_same_v<T, int64_t>) return DType::Int64;
+    else if constexpr (std::is_same_v<T, float>) return DType::Float32;
+    else if constexpr (std::is_same_v<T, double>) return DType::Float64;
+    else static_assert(sizeof(T) == 0, "No binary format for this element type");
+}
+
+Header makeHeader(DType dtype, size_t rows, size_t cols, size_t stride);
+
+// Проверяет заголовок и возвращает размер данных в байтах; бросает std::runtime_error
+size_t checkHeader(const Header& header, DType dtype, size_t elem_size);
+
+}
+
+// Матрица только для чтения поверх отображённого в память файла: данные не копируются
+template<class T>
+class MappedMatrix : public MatrixExpr<MappedMatrix<T>> {
+public:
+    using value_type = T;
+
+    explicit MappedMatrix(const std::string& path);
+
+    size_t getRows() const { return _n; }
+    size_t getCols() const { return _m; }
+    size_t getStride() const noexcept { return _stride; }
+
+    const T& operator()(size_t i, size_t j) const { return _data[i * _stride + j]; }
+    const T& at(size_t i, size_t j) const;
+    std::span<const T> row(size_t i) const;
+    const T* data() const noexcept { return _data; }
+
+    // Вид на отображённые данные без копирования, например для multiplyInto
+    MatrixView<const T> view() const noexcept { return MatrixView<const T>(_data, _n, _m, _stride); }
+    MatrixView<const T> block(size_t i0, size_t j0, size_t rows, size_t cols) const {
+        return view().block(i0, j0, rows, cols);
+    }
+
+    T coeff(size_t i, size_t j) const { return _data[i * _stride + j]; }
+    bool aliases(const matrix_expr::Target& target) const {
+        return matrix_expr::leafAliases(target, _data, _data + _n * _stride, _stride, 1);
+    }
+
+private:
+    MappedFile _file;
+    const T* _data;
+    size_t _n;
+    size_t _m;
+    size_t _stride;
+};
+
+namespace matrix_expr {
+
+template<class T>
+struct Storage<MappedMatrix<T>> {
+    using type = const MappedMatrix<T>&;
+};
+
+}
+
+template<class T>
+MappedMatrix<T>::MappedMatrix(const std::string& path) : _file(path) {
+    std::string_view bytes = _file.view();
+    if (bytes.size() < sizeof(matrix_io::Header)) throw std::runtime_error("Matrix file is truncated: " + path);
+
+    const auto* header = reinterpret_cast<const matrix_io::Header*>(bytes.data());
+    size_t payload = matrix_io::checkHeader(*header, matrix_io::dtypeOf<T>(), sizeof(T));
+    if (bytes.size() - sizeof(matrix_io::Header) < payload)
+        throw std::runtime_error("Matrix file is truncated: " + path);
+
+    _data = reinterpret_cast<const T*>(bytes.data() + sizeof(matrix_io::Header));
+    _n = header->rows;
+    _m = header->cols;
+    _stride = header->stride;
+}
+
+template<class T>
+const T& MappedMatrix<T>::at(size_t i, size_t j) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    if (j >= _m) throw std::out_of_range("Column index out of range");
+    return _data[i * _stride + j];
+}
+
+template<class T>
+std::span<const T> MappedMatrix<T>::row(size_t i) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return std::span<const T>(_data + i * _stride, _m);
+}
+
+#endif
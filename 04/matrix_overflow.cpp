@@ -0,0 +1,86 @@
+#include "matrix_overflow.h"
+
+#include <immintrin.h>
+
+namespace overflow_kernel {
+namespace {
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// В AVX2 нет насыщающего сложения 32-битных чисел, поэтому маска переполнения строится из знаковых битов,
+// а насыщенное значение подставляется через blendv
+__attribute__((target("avx2")))
+inline __m256i saturatedAvx2(__m256i sign) {
+    return _mm256_xor_si256(_mm256_srai_epi32(sign, 31), _mm256_set1_epi32(std::numeric_limits<int32_t>::max()));
+}
+
+template<bool Subtract>
+__attribute__((target("avx2")))
+bool addSubAvx2(const int32_t* a, const int32_t* b, int32_t* c, size_t count, bool saturate) {
+    __m256i flags = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i s;
+        __m256i sign;
+        if constexpr (Subtract) {
+            s = _mm256_sub_epi32(va, vb);
+            sign = _mm256_and_si256(_mm256_xor_si256(va, vb), _mm256_xor_si256(va, s));
+        } else {
+            s = _mm256_add_epi32(va, vb);
+            sign = _mm256_and_si256(_mm256_xor_si256(va, s), _mm256_xor_si256(vb, s));
+        }
+        __m256i mask = _mm256_srai_epi32(sign, 31);
+        flags = _mm256_or_si256(flags, mask);
+        if (saturate) s = _mm256_blendv_epi8(s, saturatedAvx2(va), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i), s);
+    }
+    bool tail = Subtract ? sub<int32_t>(a + i, b + i, c + i, count - i, saturate)
+                         : add<int32_t>(a + i, b + i, c + i, count - i, saturate);
+    return !_mm256_testz_si256(flags, flags) || tail;
+}
+
+// Полные 64-битные произведения чётных и нечётных элементов дают старшие половины; произведение
+// помещается в int32_t, только если старшая половина - размноженный знак младшей
+__attribute__((target("avx2")))
+bool scaleAvx2(const int32_t* a, int32_t k, int32_t* c, size_t count, bool saturate) {
+    const __m256i vk = _mm256_set1_epi32(k);
+    __m256i flags = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i lo = _mm256_mullo_epi32(va, vk);
+        __m256i even = _mm256_mul_epi32(va, vk);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(va, 32), vk);
+        __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0b10101010);
+        __m256i mask = _mm256_xor_si256(_mm256_cmpeq_epi32(hi, _mm256_srai_epi32(lo, 31)), _mm256_set1_epi32(-1));
+        flags = _mm256_or_si256(flags, mask);
+        if (saturate) lo = _mm256_blendv_epi8(lo, saturatedAvx2(_mm256_xor_si256(va, vk)), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i), lo);
+    }
+    bool tail = scale<int32_t>(a + i, k, c + i, count - i, saturate);
+    return !_mm256_testz_si256(flags, flags) || tail;
+}
+
+}
+
+bool add(const int32_t* a, const int32_t* b, int32_t* c, size_t count, bool saturate) {
+    if (hasAvx2()) return addSubAvx2<false>(a, b, c, count, saturate);
+    return add<int32_t>(a, b, c, count, saturate);
+}
+
+bool sub(const int32_t* a, const int32_t* b, int32_t* c, size_t count, bool saturate) {
+    if (hasAvx2()) return addSubAvx2<true>(a, b, c, count, saturate);
+    return sub<int32_t>(a, b, c, count, saturate);
+}
+
+bool scale(const int32_t* a, int32_t k, int32_t* c, size_t count, bool saturate) {
+    if (hasAvx2()) return scaleAvx2(a, k, c, count, saturate);
+    return scale<int32_t>(a, k, c, count, saturate);
+}
+
+}
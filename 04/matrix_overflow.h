@@ -0,0 +1,77 @@
+#ifndef MATRIX_OVERFLOW_H
+#define MATRIX_OVERFLOW_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+// Wrap - переполнение заворачивается, как у операторов; Saturate - результат прижимается к границе типа;
+// Checked - при переполнении бросается std::overflow_error
+enum class Overflow { Wrap, Saturate, Checked };
+
+// Ядра обрабатывают count подряд лежащих элементов без ветвлений: признак переполнения каждого элемента
+// копится по ИЛИ и проверяется один раз в конце. Возвращают true, если переполнился хотя бы один элемент;
+// при saturate такие элементы насыщаются, иначе заворачиваются. c может совпадать с a
+namespace overflow_kernel {
+
+bool add(const int32_t* a, const int32_t* b, int32_t* c, size_t count, bool saturate);
+bool sub(const int32_t* a, const int32_t* b, int32_t* c, size_t count, bool saturate);
+bool scale(const int32_t* a, int32_t k, int32_t* c, size_t count, bool saturate);
+
+namespace detail {
+
+template<class T>
+using Unsigned = std::make_unsigned_t<T>;
+
+// Граница, к которой прижимается результат с тем же знаком, что и sign: MAX при sign >= 0, иначе MIN
+template<class T>
+constexpr T saturated(T sign) {
+    return static_cast<T>((sign >> (std::numeric_limits<T>::digits)) ^ std::numeric_limits<T>::max());
+}
+
+}
+
+template<class T>
+bool add(const T* a, const T* b, T* c, size_t count, bool saturate) {
+    using U = detail::Unsigned<T>;
+    U flags = 0;
+    for (size_t i = 0; i < count; ++i) {
+        T s = static_cast<T>(static_cast<U>(a[i]) + static_cast<U>(b[i]));
+        // Переполнение - когда знак суммы отличается от знаков обоих слагаемых
+        T overflowed = static_cast<T>((a[i] ^ s) & (b[i] ^ s)) >> std::numeric_limits<T>::digits;
+        flags |= static_cast<U>(overflowed);
+        c[i] = saturate ? static_cast<T>((s & ~overflowed) | (detail::saturated(a[i]) & overflowed)) : s;
+    }
+    return flags != 0;
+}
+
+template<class T>
+bool sub(const T* a, const T* b, T* c, size_t count, bool saturate) {
+    using U = detail::Unsigned<T>;
+    U flags = 0;
+    for (size_t i = 0; i < count; ++i) {
+        T s = static_cast<T>(static_cast<U>(a[i]) - static_cast<U>(b[i]));
+        T overflowed = static_cast<T>((a[i] ^ b[i]) & (a[i] ^ s)) >> std::numeric_limits<T>::digits;
+        flags |= static_cast<U>(overflowed);
+        c[i] = saturate ? static_cast<T>((s & ~overflowed) | (detail::saturated(a[i]) & overflowed)) : s;
+    }
+    return flags != 0;
+}
+
+template<class T>
+bool scale(const T* a, T k, T* c, size_t count, bool saturate) {
+    bool flags = false;
+    for (size_t i = 0; i < count; ++i) {
+        T p;
+        bool overflowed = __builtin_mul_overflow(a[i], k, &p);
+        flags |= overflowed;
+        if (saturate && overflowed) p = detail::saturated(static_cast<T>(a[i] ^ k));
+        c[i] = p;
+    }
+    return flags;
+}
+
+}
+
+#endif
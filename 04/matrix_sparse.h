@@ -0,0 +1,114 @@
+#ifndef MATRIX_SPARSE_H
+#define MATRIX_SPARSE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "matrix.h"
+
+template<class T>
+class CsrMatrix;
+
+// Список троек (строка, столбец, значение) в порядке добавления; повторные позиции суммируются
+// при переводе в другие форматы. Удобен для сборки, для вычислений переводится в CSR.
+// Выражением не является (элемент пришлось бы искать перебором всех троек), поэтому сравнение
+// с матрицами и печать идут через CSR
+template<class T>
+class CooMatrix {
+public:
+    using value_type = T;
+    using Index = uint32_t;
+
+    CooMatrix(size_t n = 0, size_t m = 0);
+    explicit CooMatrix(const BasicMatrix<T>& dense);
+
+    size_t getRows() const { return _n; }
+    size_t getCols() const { return _m; }
+    size_t nonZeros() const { return _values.size(); }
+
+    void reserve(size_t count);
+    void insert(size_t i, size_t j, T value);
+
+    std::span<const Index> rowIndices() const { return _row_idx; }
+    std::span<const Index> colIndices() const { return _col_idx; }
+    std::span<const T> values() const { return _values; }
+
+    BasicMatrix<T> toDense() const;
+    CsrMatrix<T> toCsr() const;
+
+    // Последовательно: разные тройки могут писать в одну строку результата
+    std::vector<T> operator*(std::span<const T> x) const;
+
+private:
+    size_t _n;
+    size_t _m;
+    std::vector<Index> _row_idx;
+    std::vector<Index> _col_idx;
+    std::vector<T> _values;
+};
+
+// Сжатые строки: значения строки i лежат в _values[_row_ptr[i], _row_ptr[i + 1]) по возрастанию столбцов.
+// Является выражением, поэтому сравнивается и печатается вместе с плотными матрицами
+template<class T>
+class CsrMatrix : public MatrixExpr<CsrMatrix<T>> {
+public:
+    using value_type = T;
+    using Index = uint32_t;
+
+    // Меньшие произведения считаются в одном потоке
+    static constexpr size_t kParallelThreshold = size_t(1) << 15;
+
+    CsrMatrix(size_t n = 0, size_t m = 0);
+    explicit CsrMatrix(const BasicMatrix<T>& dense);
+    explicit CsrMatrix(const CooMatrix<T>& coo);
+
+    size_t getRows() const { return _n; }
+    size_t getCols() const { return _m; }
+    size_t nonZeros() const { return _values.size(); }
+
+    // Двоичный поиск по строке; для обхода всех элементов используйте columns() и values()
+    T coeff(size_t i, size_t j) const;
+    bool aliases(const matrix_expr::Target& target) const {
+        return matrix_expr::overlaps(target.data, target.end, _values.data(), _values.data() + _values.size());
+    }
+
+    std::span<const Index> columns(size_t i) const;
+    std::span<const T> values(size_t i) const;
+
+    BasicMatrix<T> toDense() const;
+
+    BasicMatrix<T> operator*(const BasicMatrix<T>& dense) const;
+    std::vector<T> operator*(std::span<const T> x) const;
+
+private:
+    // Делит строки на куски с примерно равным числом ненулевых элементов
+    template<class Fn>
+    void forEachRowBlock(size_t work_per_nonzero, Fn&& fn) const;
+
+    size_t _n;
+    size_t _m;
+    std::vector<size_t> _row_ptr;
+    std::vector<Index> _col_idx;
+    std::vector<T> _values;
+};
+
+namespace matrix_expr {
+
+template<class T>
+struct Storage<CsrMatrix<T>> {
+    using type = const CsrMatrix<T>&;
+};
+
+}
+
+template<class T, class E>
+bool operator==(const CooMatrix<T>& lhs, const MatrixExpr<E>& rhs);
+template<class T>
+bool operator==(const CooMatrix<T>& lhs, const CooMatrix<T>& rhs);
+template<class T>
+std::ostream& operator<<(std::ostream& os, const CooMatrix<T>& coo);
+
+#include "matrix_sparse.hpp"
+
+#endif
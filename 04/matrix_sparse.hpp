@@ -0,0 +1,230 @@
+#ifndef MATRIX_SPARSE_HPP
+#define MATRIX_SPARSE_HPP
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace matrix_sparse_detail {
+
+inline void checkDimensions(size_t n, size_t m) {
+    if (n > std::numeric_limits<uint32_t>::max() || m > std::numeric_limits<uint32_t>::max())
+        throw std::length_error("Sparse matrix dimensions exceed 32-bit indices");
+}
+
+}
+
+template<class T>
+CooMatrix<T>::CooMatrix(size_t n, size_t m) : _n(n), _m(m) {
+    matrix_sparse_detail::checkDimensions(n, m);
+}
+
+template<class T>
+CooMatrix<T>::CooMatrix(const BasicMatrix<T>& dense) : CooMatrix(dense.getRows(), dense.getCols()) {
+    for (size_t i = 0; i < _n; ++i) {
+        std::span<const T> row = dense.row(i);
+        for (size_t j = 0; j < _m; ++j)
+            if (row[j] != T(0)) insert(i, j, row[j]);
+    }
+}
+
+template<class T>
+void CooMatrix<T>::reserve(size_t count) {
+    _row_idx.reserve(count);
+    _col_idx.reserve(count);
+    _values.reserve(count);
+}
+
+template<class T>
+void CooMatrix<T>::insert(size_t i, size_t j, T value) {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    if (j >= _m) throw std::out_of_range("Column index out of range");
+    _row_idx.push_back(static_cast<Index>(i));
+    _col_idx.push_back(static_cast<Index>(j));
+    _values.push_back(value);
+}
+
+template<class T>
+BasicMatrix<T> CooMatrix<T>::toDense() const {
+    BasicMatrix<T> res(_n, _m);
+    for (size_t k = 0; k < _values.size(); ++k) {
+        T& dst = res(_row_idx[k], _col_idx[k]);
+        dst = matrix_expr::wrapAdd(dst, _values[k]);
+    }
+    return res;
+}
+
+template<class T>
+CsrMatrix<T> CooMatrix<T>::toCsr() const {
+    return CsrMatrix<T>(*this);
+}
+
+template<class T>
+std::vector<T> CooMatrix<T>::operator*(std::span<const T> x) const {
+    if (x.size() != _m) throw std::invalid_argument("Incompatible dimensions");
+    std::vector<T> y(_n, T(0));
+    for (size_t k = 0; k < _values.size(); ++k)
+        y[_row_idx[k]] = matrix_expr::wrapAdd(y[_row_idx[k]], matrix_expr::wrapMul(_values[k], x[_col_idx[k]]));
+    return y;
+}
+
+template<class T, class E>
+bool operator==(const CooMatrix<T>& lhs, const MatrixExpr<E>& rhs) {
+    return lhs.toCsr() == rhs;
+}
+
+template<class T>
+bool operator==(const CooMatrix<T>& lhs, const CooMatrix<T>& rhs) {
+    return lhs.toCsr() == rhs.toCsr();
+}
+
+template<class T>
+std::ostream& operator<<(std::ostream& os, const CooMatrix<T>& coo) {
+    return os << coo.toCsr();
+}
+
+template<class T>
+CsrMatrix<T>::CsrMatrix(size_t n, size_t m) : _n(n), _m(m), _row_ptr(n + 1, 0) {
+    matrix_sparse_detail::checkDimensions(n, m);
+}
+
+template<class T>
+CsrMatrix<T>::CsrMatrix(const BasicMatrix<T>& dense) : CsrMatrix(dense.getRows(), dense.getCols()) {
+    for (size_t i = 0; i < _n; ++i) {
+        std::span<const T> row = dense.row(i);
+        for (size_t j = 0; j < _m; ++j) {
+            if (row[j] == T(0)) continue;
+            _col_idx.push_back(static_cast<Index>(j));
+            _values.push_back(row[j]);
+        }
+        _row_ptr[i + 1] = _values.size();
+    }
+}
+
+// Подсчётом по строкам тройки раскладываются по местам, затем каждая строка сортируется по столбцам
+// и повторы схлопываются в сумму
+template<class T>
+CsrMatrix<T>::CsrMatrix(const CooMatrix<T>& coo) : CsrMatrix(coo.getRows(), coo.getCols()) {
+    std::span<const Index> rows = coo.rowIndices();
+    std::span<const Index> cols = coo.colIndices();
+    std::span<const T> vals = coo.values();
+
+    for (Index r : rows) ++_row_ptr[r + 1];
+    std::partial_sum(_row_ptr.begin(), _row_ptr.end(), _row_ptr.begin());
+
+    std::vector<std::pair<Index, T>> entries(vals.size());
+    std::vector<size_t> next(_row_ptr.begin(), _row_ptr.end() - 1);
+    for (size_t k = 0; k < vals.size(); ++k)
+        entries[next[rows[k]]++] = {cols[k], vals[k]};
+
+    _col_idx.reserve(entries.size());
+    _values.reserve(entries.size());
+    size_t begin = 0;
+    for (size_t i = 0; i < _n; ++i) {
+        size_t end = _row_ptr[i + 1];
+        std::sort(entries.begin() + begin, entries.begin() + end,
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t k = begin; k < end; ++k) {
+            if (k > begin && entries[k].first == entries[k - 1].first)
+                _values.back() = matrix_expr::wrapAdd(_values.back(), entries[k].second);
+            else {
+                _col_idx.push_back(entries[k].first);
+                _values.push_back(entries[k].second);
+            }
+        }
+        begin = end;
+        _row_ptr[i + 1] = _values.size();
+    }
+}
+
+template<class T>
+T CsrMatrix<T>::coeff(size_t i, size_t j) const {
+    auto first = _col_idx.begin() + _row_ptr[i];
+    auto last = _col_idx.begin() + _row_ptr[i + 1];
+    auto it = std::lower_bound(first, last, static_cast<Index>(j));
+    if (it == last || *it != j) return T(0);
+    return _values[it - _col_idx.begin()];
+}
+
+template<class T>
+std::span<const typename CsrMatrix<T>::Index> CsrMatrix<T>::columns(size_t i) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return std::span<const Index>(_col_idx.data() + _row_ptr[i], _row_ptr[i + 1] - _row_ptr[i]);
+}
+
+template<class T>
+std::span<const T> CsrMatrix<T>::values(size_t i) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    return std::span<const T>(_values.data() + _row_ptr[i], _row_ptr[i + 1] - _row_ptr[i]);
+}
+
+template<class T>
+BasicMatrix<T> CsrMatrix<T>::toDense() const {
+    BasicMatrix<T> res(_n, _m);
+    for (size_t i = 0; i < _n; ++i) {
+        std::span<T> row = res.row(i);
+        for (size_t k = _row_ptr[i]; k < _row_ptr[i + 1]; ++k)
+            row[_col_idx[k]] = _values[k];
+    }
+    return res;
+}
+
+// Кусок ненулевых элементов [lo, hi) обрабатывает строки, которые в нём начинаются, так что каждая строка
+// достаётся ровно одному потоку, а длинные строки не перегружают один кусок множеством соседних
+template<class T>
+template<class Fn>
+void CsrMatrix<T>::forEachRowBlock(size_t work_per_nonzero, Fn&& fn) const {
+    size_t nnz = _values.size();
+    size_t work = nnz * std::max<size_t>(work_per_nonzero, 1);
+    if (work < kParallelThreshold) {
+        fn(size_t(0), _n);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, kParallelThreshold / 2 / std::max<size_t>(work_per_nonzero, 1));
+    auto starts_begin = _row_ptr.begin();
+    auto starts_end = _row_ptr.begin() + _n;
+    ThreadPool::global().parallelFor(0, nnz, grain, [&](size_t lo, size_t hi) {
+        size_t first = std::lower_bound(starts_begin, starts_end, lo) - starts_begin;
+        size_t last = hi == nnz ? _n : std::lower_bound(starts_begin, starts_end, hi) - starts_begin;
+        if (first < last) fn(first, last);
+    });
+}
+
+template<class T>
+BasicMatrix<T> CsrMatrix<T>::operator*(const BasicMatrix<T>& dense) const {
+    if (_m != dense.getRows()) throw std::invalid_argument("Incompatible dimensions");
+
+    BasicMatrix<T> res(_n, dense.getCols());
+    const size_t m = dense.getCols();
+    forEachRowBlock(m, [this, &dense, &res, m](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* dst = res.row(i).data();
+            for (size_t k = _row_ptr[i]; k < _row_ptr[i + 1]; ++k) {
+                const T v = _values[k];
+                const T* src = dense.data() + _col_idx[k] * dense.getStride();
+                for (size_t j = 0; j < m; ++j)
+                    dst[j] = matrix_expr::wrapAdd(dst[j], matrix_expr::wrapMul(v, src[j]));
+            }
+        }
+    });
+    return res;
+}
+
+template<class T>
+std::vector<T> CsrMatrix<T>::operator*(std::span<const T> x) const {
+    if (x.size() != _m) throw std::invalid_argument("Incompatible dimensions");
+
+    std::vector<T> y(_n, T(0));
+    forEachRowBlock(1, [this, x, &y](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T sum = T(0);
+            for (size_t k = _row_ptr[i]; k < _row_ptr[i + 1]; ++k)
+                sum = matrix_expr::wrapAdd(sum, matrix_expr::wrapMul(_values[k], x[_col_idx[k]]));
+            y[i] = sum;
+        }
+    });
+    return y;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "matrix_expr.h"
+#include "thread_pool.h"
+
+// Невладеющий вид на матрицу: элемент (i, j) лежит в data[i * row_stride + j * col_stride].
+// Подматрицы, строки, столбцы и транспонирование получаются без копирования, меняются только шаги.
+// Копия вида ссылается на те же данные, а присваивание виду записывает элементы, как у BasicMatrix.
+// MatrixView<const T> - вид только для чтения
+template<class T>
+class MatrixView : public MatrixExpr<MatrixView<T>> {
+public:
+    using value_type = std::remove_const_t<T>;
+
+    // Поэлементные операции над меньшим числом элементов выполняются в одном потоке
+    static constexpr size_t kParallelThreshold = size_t(1) << 15;
+
+    MatrixView(T* data = nullptr, size_t rows = 0, size_t cols = 0, size_t row_stride = 0, size_t col_stride = 1)
+        : _data(data), _n(rows), _m(cols), _row_stride(row_stride), _col_stride(col_stride) {}
+
+    MatrixView(const MatrixView& other) = default;
+
+    template<class U>
+        requires (std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+    MatrixView(const MatrixView<U>& other)
+        : MatrixView(other.data(), other.getRows(), other.getCols(), other.getRowStride(), other.getColStride()) {}
+
+    MatrixView& operator=(const MatrixView& other);
+
+    template<class E>
+    MatrixView& operator=(const MatrixExpr<E>& expr);
+    template<class E>
+    MatrixView& operator+=(const MatrixExpr<E>& expr);
+    template<class E>
+    MatrixView& operator-=(const MatrixExpr<E>& expr);
+    MatrixView& operator*=(value_type k);
+
+    size_t getRows() const { return _n; }
+    size_t getCols() const { return _m; }
+    size_t getRowStride() const noexcept { return _row_stride; }
+    size_t getColStride() const noexcept { return _col_stride; }
+    T* data() const noexcept { return _data; }
+
+    T& operator()(size_t i, size_t j) const { return _data[i * _row_stride + j * _col_stride]; }
+    T& at(size_t i, size_t j) const;
+    value_type coeff(size_t i, size_t j) const { return _data[i * _row_stride + j * _col_stride]; }
+
+    MatrixView block(size_t i0, size_t j0, size_t rows, size_t cols) const;
+    MatrixView rowView(size_t i) const { return block(i, 0, 1, _m); }
+    MatrixView colView(size_t j) const { return block(0, j, _n, 1); }
+    MatrixView transposed() const { return MatrixView(_data, _m, _n, _col_stride, _row_stride); }
+
+    // Пересекаются ли элементы вида с памятью [begin, end)
+    bool overlaps(const void* begin, const void* end) const;
+    bool aliases(const matrix_expr::Target& target) const;
+
+private:
+    template<class E, class Op>
+    void update(const E& expr, Op op);
+
+    template<class Fn>
+    void forEachRowBlock(Fn&& fn) const;
+
+    const T* end() const noexcept { return _data + (_n - 1) * _row_stride + (_m - 1) * _col_stride + 1; }
+
+    T* _data;
+    size_t _n;
+    size_t _m;
+    size_t _row_stride;
+    size_t _col_stride;
+};
+
+template<class T>
+T& MatrixView<T>::at(size_t i, size_t j) const {
+    if (i >= _n) throw std::out_of_range("Row index out of range");
+    if (j >= _m) throw std::out_of_range("Column index out of range");
+    return (*this)(i, j);
+}
+
+template<class T>
+MatrixView<T> MatrixView<T>::block(size_t i0, size_t j0, size_t rows, size_t cols) const {
+    if (i0 > _n || rows > _n - i0) throw std::out_of_range("Block rows out of range");
+    if (j0 > _m || cols > _m - j0) throw std::out_of_range("Block columns out of range");
+    return MatrixView(_data + i0 * _row_stride + j0 * _col_stride, rows, cols, _row_stride, _col_stride);
+}
+
+template<class T>
+bool MatrixView<T>::overlaps(const void* begin, const void* end) const {
+    if (_n == 0 || _m == 0) return false;
+    return matrix_expr::overlaps(begin, end, _data, this->end());
+}
+
+template<class T>
+bool MatrixView<T>::aliases(const matrix_expr::Target& target) const {
+    if (_n == 0 || _m == 0) return false;
+    return matrix_expr::leafAliases(target, _data, end(), _row_stride, _col_stride);
+}
+
+template<class T>
+template<class Fn>
+void MatrixView<T>::forEachRowBlock(Fn&& fn) const {
+    if (_n * _m < kParallelThreshold) {
+        fn(size_t(0), _n);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, kParallelThreshold / 2 / std::max<size_t>(_m, 1));
+    ThreadPool::global().parallelFor(0, _n, grain, fn);
+}
+
+// Если правая часть читает ту же память в другом порядке (например, исходную матрицу при записи
+// в её транспонированный вид), она сначала вычисляется во временную матрицу
+template<class T>
+template<class E, class Op>
+void MatrixView<T>::update(const E& expr, Op op) {
+    static_assert(!std::is_const_v<T>, "Cannot write through a read-only view");
+    static_assert(std::is_same_v<typename E::value_type, value_type>, "Element types differ");
+    if (_n != expr.getRows() || _m != expr.getCols()) throw std::invalid_argument("Different dimensions");
+    if (_n == 0 || _m == 0) return;
+    if (expr.aliases(matrix_expr::Target{_data, end(), _row_stride, _col_stride})) {
+        update(BasicMatrix<value_type>(expr), op);
+        return;
+    }
+    forEachRowBlock([this, &expr, op](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = _data + i * _row_stride;
+            for (size_t j = 0; j < _m; ++j)
+                row[j * _col_stride] = op(row[j * _col_stride], expr.coeff(i, j));
+        }
+    });
+}
+
+template<class T>
+MatrixView<T>& MatrixView<T>::operator=(const MatrixView& other) {
+    update(other, [](value_type, value_type b) { return b; });
+    return *this;
+}
+
+template<class T>
+template<class E>
+MatrixView<T>& MatrixView<T>::operator=(const MatrixExpr<E>& expr) {
+    update(expr.self(), [](value_type, value_type b) { return b; });
+    return *this;
+}
+
+template<class T>
+template<class E>
+MatrixView<T>& MatrixView<T>::operator+=(const MatrixExpr<E>& expr) {
+    update(expr.self(), matrix_expr::Add());
+    return *this;
+}
+
+template<class T>
+template<class E>
+MatrixView<T>& MatrixView<T>::operator-=(const MatrixExpr<E>& expr) {
+    update(expr.self(), matrix_expr::Sub());
+    return *this;
+}
+
+template<class T>
+MatrixView<T>& MatrixView<T>::operator*=(value_type k) {
+    static_assert(!std::is_const_v<T>, "Cannot write through a read-only view");
+    forEachRowBlock([this, k](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = _data + i * _row_stride;
+            for (size_t j = 0; j < _m; ++j)
+                row[j * _col_stride] = matrix_expr::wrapMul(row[j * _col_stride], k);
+        }
+    });
+    return *this;
+}
+
+#endif
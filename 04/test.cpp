@@ -1,6 +1,14 @@
 #include "matrix.h"
+#include "matrix_sparse.h"
+#include "thread_pool.h"
 #include <gtest/gtest.h>
 #include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <system_error>
+#include <limits>
+#include <atomic>
+#include <vector>
 
 TEST(MatrixTest, DefaultConstructor) {
     Matrix m;
@@ -263,6 +271,710 @@ TEST(MatrixTest, LargeMatrix) {
     }
 }
 
+TEST(MatrixTest, ContiguousAlignedRows) {
+    Matrix m(5, 7);
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&m[i][0]) % Matrix::kAlignment, 0);
+        if (i > 0) {
+            EXPECT_GT(&m[i][0], &m[i - 1][6]);
+        }
+    }
+
+    m[4][6] = 42;
+    Matrix copy = m;
+    EXPECT_EQ(copy[4][6], 42);
+    EXPECT_NE(&copy[4][6], &m[4][6]);
+    EXPECT_EQ(copy, m);
+}
+
+static Matrix naiveProduct(const Matrix& a, const Matrix& b) {
+    Matrix res(a.getRows(), b.getCols());
+    for (size_t i = 0; i < a.getRows(); ++i)
+        for (size_t j = 0; j < b.getCols(); ++j) {
+            uint32_t sum = 0;
+            for (size_t p = 0; p < a.getCols(); ++p)
+                sum += static_cast<uint32_t>(a[i][p]) * static_cast<uint32_t>(b[p][j]);
+            res[i][j] = static_cast<int32_t>(sum);
+        }
+    return res;
+}
+
+static Matrix patternMatrix(size_t n, size_t m, int32_t seed) {
+    Matrix res(n, m);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < m; ++j)
+            res[i][j] = static_cast<int32_t>((i * 31 + j * 17 + seed) % 23) - 11;
+    return res;
+}
+
+TEST(MatrixTest, MatrixProduct) {
+    Matrix a(2, 3);
+    a[0][0] = 1; a[0][1] = 2; a[0][2] = 3;
+    a[1][0] = 4; a[1][1] = 5; a[1][2] = 6;
+    Matrix b(3, 2);
+    b[0][0] = 7;  b[0][1] = 8;
+    b[1][0] = 9;  b[1][1] = 10;
+    b[2][0] = 11; b[2][1] = 12;
+
+    Matrix c = a * b;
+    EXPECT_EQ(c.getRows(), 2);
+    EXPECT_EQ(c.getCols(), 2);
+    EXPECT_EQ(c[0][0], 58);
+    EXPECT_EQ(c[0][1], 64);
+    EXPECT_EQ(c[1][0], 139);
+    EXPECT_EQ(c[1][1], 154);
+
+    EXPECT_THROW(a * a, std::invalid_argument);
+}
+
+TEST(MatrixTest, BlockedProductMatchesNaive) {
+    const size_t sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {17, 300, 33}, {131, 259, 70}, {64, 64, 64}};
+    for (const auto& size : sizes) {
+        Matrix a = patternMatrix(size[0], size[1], 1);
+        Matrix b = patternMatrix(size[1], size[2], 2);
+        Matrix expected = naiveProduct(a, b);
+        EXPECT_EQ(a * b, expected);
+        EXPECT_EQ(a.multiply(b, Matrix::Accumulation::Int64), expected);
+    }
+}
+
+TEST(MatrixTest, WideAccumulation) {
+    Matrix a(1, 2);
+    a[0][0] = 2000000000;
+    a[0][1] = -2000000000;
+    Matrix b(2, 1);
+    b[0][0] = 3;
+    b[1][0] = 3;
+
+    EXPECT_EQ(a.multiply(b, Matrix::Accumulation::Int64)[0][0], 0);
+
+    b[1][0] = 1;
+    EXPECT_THROW(a.multiply(b, Matrix::Accumulation::Int64), std::overflow_error);
+    EXPECT_EQ(a.multiply(b)[0][0], static_cast<int32_t>(4000000000u));
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRange) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(0, hits.size(), 7, [&hits](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) ++hits[i];
+    });
+    for (const auto& hit : hits)
+        EXPECT_EQ(hit.load(), 1);
+}
+
+TEST(ThreadPoolTest, NestedAndExceptions) {
+    ThreadPool pool(3);
+    std::atomic<size_t> total(0);
+    pool.parallelFor(0, 8, 1, [&pool, &total](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i)
+            pool.parallelFor(0, 100, 10, [&total](size_t a, size_t b) { total += b - a; });
+    });
+    EXPECT_EQ(total.load(), 800);
+
+    EXPECT_THROW(pool.parallelFor(0, 100, 1, [](size_t lo, size_t hi) {
+        if (lo <= 50 && 50 < hi) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+}
+
+TEST(MatrixTest, ParallelOperationsMatchSerial) {
+    Matrix a = patternMatrix(300, 200, 3);
+    Matrix b = patternMatrix(300, 200, 4);
+    Matrix c = patternMatrix(200, 150, 5);
+
+    Matrix sum_serial = a + b;
+    Matrix scaled_serial = a;
+    scaled_serial *= -7;
+    Matrix product_serial = a * c;
+
+    ThreadPool::setGlobalThreads(4);
+    Matrix scaled = a;
+    scaled *= -7;
+    EXPECT_EQ(a + b, sum_serial);
+    EXPECT_EQ(scaled, scaled_serial);
+    EXPECT_EQ(a * c, product_serial);
+    EXPECT_EQ(a * c, naiveProduct(a, c));
+    ThreadPool::setGlobalThreads(0);
+}
+
+template<class L, class R>
+concept CanLazyAdd = requires(L&& lhs, R&& rhs) { lazyAdd(std::forward<L>(lhs), std::forward<R>(rhs)); };
+
+TEST(MatrixTest, FusedExpression) {
+    Matrix a = patternMatrix(3, 4, 1);
+    Matrix b = patternMatrix(3, 4, 2);
+    Matrix c = patternMatrix(3, 4, 3);
+
+    Matrix result = lazySub(lazyAdd(lazyAdd(a, b), lazyScale(c, 3)), lazyScale(a, 2));
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            EXPECT_EQ(result[i][j], a[i][j] + b[i][j] + c[i][j] * 3 - 2 * a[i][j]);
+    EXPECT_EQ(result, a + b + c * 3 - 2 * a);
+
+    auto expr = lazyAdd(a, b);
+    a[0][0] = 100;
+    Matrix lazy = expr;
+    EXPECT_EQ(lazy[0][0], 100 + b[0][0]);
+
+    Matrix other(4, 3);
+    EXPECT_THROW(lazyAdd(lazyAdd(a, b), other), std::invalid_argument);
+    EXPECT_THROW(a + b + Matrix(4, 3), std::invalid_argument);
+
+    // Временная матрица-лист повисла бы, поэтому такие узлы не строятся
+    static_assert(!CanLazyAdd<Matrix, const Matrix&>);
+    static_assert(!CanLazyAdd<const Matrix&, Matrix>);
+    static_assert(CanLazyAdd<const Matrix&, Matrix&>);
+    static_assert(CanLazyAdd<AddExpr<Matrix, Matrix>, const Matrix&>);
+    static_assert(CanLazyAdd<MatrixView<int32_t>, MatrixView<const int32_t>>);
+}
+
+TEST(MatrixTest, EagerOperatorResults) {
+    Matrix a = patternMatrix(3, 4, 1);
+    Matrix b = patternMatrix(3, 4, 2);
+
+    EXPECT_EQ((a + b)[0][0], a[0][0] + b[0][0]);
+    EXPECT_EQ((a - b)[2][3], a[2][3] - b[2][3]);
+    EXPECT_EQ((a * 3)[1][2], a[1][2] * 3);
+    EXPECT_EQ((2 * a).at(2, 1), 2 * a[2][1]);
+
+    auto sum = a + b;
+    static_assert(std::is_same_v<decltype(sum), Matrix>);
+    sum[0][0] = 1;
+    EXPECT_EQ(sum[0][0], 1);
+    EXPECT_EQ(sum[1][1], a[1][1] + b[1][1]);
+
+    auto from_temporary = patternMatrix(3, 4, 3) + b;
+    Matrix expected = patternMatrix(3, 4, 3);
+    expected += b;
+    EXPECT_EQ(from_temporary, expected);
+
+    auto scaled = a.view().transposed() * 2;
+    static_assert(std::is_same_v<decltype(scaled), Matrix>);
+    EXPECT_EQ(scaled, a.transpose() * 2);
+}
+
+TEST(MatrixTest, AliasedExpressionAssignment) {
+    Matrix a = patternMatrix(5, 5, 1);
+    Matrix b = patternMatrix(5, 5, 2);
+    Matrix expected = a + b * 2;
+
+    const int32_t* data = a.data();
+    a = lazyAdd(a, lazyScale(b, 2));
+    EXPECT_EQ(a, expected);
+    EXPECT_EQ(a.data(), data);
+
+    Matrix small(1, 1);
+    small = expected + b;
+    EXPECT_EQ(small.getRows(), 5);
+    EXPECT_EQ(small, Matrix(expected + b));
+}
+
+TEST(MatrixTest, UncheckedAccessAndRowSpans) {
+    Matrix m(3, 4);
+    for (size_t i = 0; i < m.getRows(); ++i) {
+        std::span<int32_t> row = m.row(i);
+        EXPECT_EQ(row.size(), 4);
+        for (size_t j = 0; j < row.size(); ++j)
+            row[j] = static_cast<int32_t>(i * 10 + j);
+    }
+
+    const Matrix& cm = m;
+    EXPECT_EQ(cm(2, 3), 23);
+    EXPECT_EQ(cm.at(1, 2), 12);
+    EXPECT_EQ(cm.row(1)[3], 13);
+    EXPECT_EQ(cm.data() + cm.getStride(), &cm(1, 0));
+
+    m(0, 1) = -5;
+    EXPECT_EQ(m[0][1], -5);
+    m.at(2, 0) = 7;
+    EXPECT_EQ(m(2, 0), 7);
+
+    EXPECT_THROW(m.at(3, 0), std::out_of_range);
+    EXPECT_THROW(m.at(0, 4), std::out_of_range);
+    EXPECT_THROW(cm.at(0, 4), std::out_of_range);
+    EXPECT_THROW(m.row(3), std::out_of_range);
+}
+
+TEST(MatrixTest, FloatingPointElements) {
+    BasicMatrix<double> a(2, 3);
+    BasicMatrix<double> b(3, 2);
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j) {
+            a(i, j) = 0.5 * static_cast<double>(i + j);
+            b(j, i) = 1.5 - static_cast<double>(j);
+        }
+
+    BasicMatrix<double> product = a * b;
+    EXPECT_DOUBLE_EQ(product(0, 0), 0.0 * 1.5 + 0.5 * 0.5 + 1.0 * -0.5);
+    EXPECT_DOUBLE_EQ(product(1, 1), 0.5 * 1.5 + 1.0 * 0.5 + 1.5 * -0.5);
+
+    BasicMatrix<double> sum = a + a * 2.0;
+    EXPECT_DOUBLE_EQ(sum(1, 2), 4.5);
+    EXPECT_EQ(sum, a * 3.0);
+
+    BasicMatrix<int64_t> big(1, 1);
+    big(0, 0) = int64_t(1) << 40;
+    big *= 4;
+    EXPECT_EQ(big(0, 0), int64_t(1) << 42);
+}
+
+TEST(MatrixTest, GenericProductMatchesNaive) {
+    const size_t n = 70, k = 300, m = 45;
+    Matrix a = patternMatrix(n, k, 5);
+    Matrix b = patternMatrix(k, m, 6);
+    BasicMatrix<int64_t> wa(n, k);
+    BasicMatrix<int64_t> wb(k, m);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t p = 0; p < k; ++p)
+            wa(i, p) = a(i, p);
+    for (size_t p = 0; p < k; ++p)
+        for (size_t j = 0; j < m; ++j)
+            wb(p, j) = b(p, j);
+
+    BasicMatrix<int64_t> wide = wa * wb;
+    Matrix expected = naiveProduct(a, b);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < m; ++j)
+            EXPECT_EQ(wide(i, j), expected(i, j));
+}
+
+TEST(MatrixTest, FixedSizeMatrix) {
+    constexpr Matrix4d identity = Matrix4d::identity();
+    static_assert(identity(2, 2) == 1.0 && identity(2, 1) == 0.0);
+    static_assert(sizeof(Matrix4f) == 16 * sizeof(float));
+
+    Matrix4d t = identity;
+    t(0, 3) = 2.0;
+    t(1, 3) = -1.0;
+    EXPECT_EQ(t * identity, t);
+    EXPECT_EQ(identity * t, t);
+
+    Matrix4d twice = t * t;
+    EXPECT_DOUBLE_EQ(twice(0, 3), 4.0);
+    EXPECT_DOUBLE_EQ(twice(1, 3), -2.0);
+
+    BasicMatrix<int32_t, 2, 3> a{{1, 2, 3}, {4, 5, 6}};
+    BasicMatrix<int32_t, 3, 2> b{{1, 0}, {0, 1}, {1, 1}};
+    BasicMatrix<int32_t, 2, 2> expected{{4, 5}, {10, 11}};
+    EXPECT_EQ(a * b, expected);
+    EXPECT_EQ(a + a, a * 2);
+    EXPECT_EQ(a - a, (BasicMatrix<int32_t, 2, 3>()));
+    EXPECT_EQ(a.row(1)[2], 6);
+
+    EXPECT_THROW(a.at(2, 0), std::out_of_range);
+    EXPECT_THROW(a.row(2), std::out_of_range);
+    EXPECT_THROW((BasicMatrix<int32_t, 2, 2>{{1, 2}}), std::invalid_argument);
+}
+
+TEST(SparseMatrixTest, ConversionsAndEquality) {
+    CooMatrix<int32_t> coo(3, 4);
+    coo.insert(2, 1, 7);
+    coo.insert(0, 3, 1);
+    coo.insert(2, 1, -2);
+    coo.insert(1, 0, 4);
+    EXPECT_THROW(coo.insert(3, 0, 1), std::out_of_range);
+
+    Matrix dense(3, 4);
+    dense(0, 3) = 1;
+    dense(1, 0) = 4;
+    dense(2, 1) = 5;
+
+    EXPECT_EQ(coo.toDense(), dense);
+
+    CsrMatrix<int32_t> csr = coo.toCsr();
+    EXPECT_EQ(csr.nonZeros(), 3);
+    EXPECT_EQ(csr.coeff(2, 1), 5);
+    EXPECT_EQ(csr.coeff(2, 2), 0);
+    EXPECT_EQ(csr, dense);
+    EXPECT_EQ(dense, csr);
+    EXPECT_EQ(csr.toDense(), dense);
+    EXPECT_EQ(CsrMatrix<int32_t>(dense), csr);
+    EXPECT_EQ(CooMatrix<int32_t>(dense).toCsr(), csr);
+
+    Matrix other = dense;
+    other(0, 0) = 9;
+    EXPECT_NE(csr, other);
+    EXPECT_EQ(csr + dense, dense * 2);
+
+    std::stringstream sparse_out, dense_out;
+    sparse_out << csr;
+    dense_out << dense;
+    EXPECT_EQ(sparse_out.str(), dense_out.str());
+}
+
+TEST(SparseMatrixTest, CooComparesAndPrintsLikeDense) {
+    CooMatrix<int32_t> coo(2, 3);
+    coo.insert(1, 2, 3);
+    coo.insert(0, 0, -1);
+    coo.insert(1, 2, 4);
+
+    Matrix dense(2, 3);
+    dense(0, 0) = -1;
+    dense(1, 2) = 7;
+
+    EXPECT_TRUE(coo == dense);
+    EXPECT_TRUE(dense == coo);
+    EXPECT_EQ(coo, dense.view());
+    EXPECT_EQ(coo, CsrMatrix<int32_t>(dense));
+    EXPECT_EQ(coo, CooMatrix<int32_t>(dense));
+
+    Matrix other = dense;
+    other(1, 1) = 2;
+    EXPECT_TRUE(coo != other);
+    EXPECT_TRUE(other != coo);
+    EXPECT_NE(coo, Matrix(3, 2));
+    EXPECT_NE(coo, CooMatrix<int32_t>(other));
+
+    std::stringstream coo_out, dense_out;
+    coo_out << coo;
+    dense_out << dense;
+    EXPECT_EQ(coo_out.str(), dense_out.str());
+}
+
+TEST(SparseMatrixTest, ProductsMatchDense) {
+    const size_t n = 8000, k = 500, m = 24;
+    CooMatrix<int32_t> coo(n, k);
+    for (size_t i = 0; i < n; ++i) {
+        // Строки разной длины, часть пустых
+        size_t count = (i * 7) % 13 == 0 ? 0 : (i % 5) * 3 + (i % 97 == 0 ? 200 : 0);
+        for (size_t c = 0; c < count; ++c)
+            coo.insert(i, (i * 31 + c * 17) % k, static_cast<int32_t>((i + c) % 11) - 5);
+    }
+    CsrMatrix<int32_t> csr(coo);
+    Matrix a = coo.toDense();
+    Matrix b = patternMatrix(k, m, 9);
+
+    EXPECT_EQ(csr * b, a * b);
+
+    std::vector<int32_t> x(k);
+    for (size_t p = 0; p < k; ++p) x[p] = static_cast<int32_t>(p % 23) - 11;
+    Matrix xm(k, 1);
+    for (size_t p = 0; p < k; ++p) xm(p, 0) = x[p];
+    Matrix expected = a * xm;
+
+    std::vector<int32_t> y = csr * x;
+    std::vector<int32_t> y_coo = coo * x;
+    ASSERT_EQ(y.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(y[i], expected(i, 0));
+        EXPECT_EQ(y_coo[i], expected(i, 0));
+    }
+
+    EXPECT_THROW(csr * std::vector<int32_t>(k + 1), std::invalid_argument);
+    EXPECT_THROW(csr * Matrix(k + 1, 2), std::invalid_argument);
+}
+
+TEST(MatrixTest, Transpose) {
+    Matrix a = patternMatrix(300, 170, 11);
+    Matrix t = a.transpose();
+    ASSERT_EQ(t.getRows(), 170);
+    ASSERT_EQ(t.getCols(), 300);
+    for (size_t i = 0; i < a.getRows(); ++i)
+        for (size_t j = 0; j < a.getCols(); ++j)
+            ASSERT_EQ(t(j, i), a(i, j));
+    EXPECT_EQ(t.transpose(), a);
+
+    Matrix square = patternMatrix(257, 257, 12);
+    Matrix expected = square.transpose();
+    const int32_t* buffer = square.data();
+    square.transposeInPlace();
+    EXPECT_EQ(square, expected);
+    EXPECT_EQ(square.data(), buffer);
+
+    a.transposeInPlace();
+    EXPECT_EQ(a, t);
+
+    Matrix4d m = Matrix4d::identity();
+    m(0, 3) = 5.0;
+    Matrix4d mt = m;
+    mt.transposeInPlace();
+    EXPECT_EQ(mt, m.transpose());
+    EXPECT_DOUBLE_EQ(mt(3, 0), 5.0);
+    BasicMatrix<int32_t, 2, 3> r{{1, 2, 3}, {4, 5, 6}};
+    EXPECT_EQ(r.transpose(), (BasicMatrix<int32_t, 3, 2>{{1, 4}, {2, 5}, {3, 6}}));
+}
+
+TEST(MatrixTest, InPlaceAddSub) {
+    Matrix a = patternMatrix(200, 190, 13);
+    Matrix b = patternMatrix(200, 190, 14);
+    Matrix sum = a + b;
+    Matrix diff = a - b * 2;
+
+    Matrix c = a;
+    const int32_t* buffer = c.data();
+    c += b;
+    EXPECT_EQ(c, sum);
+    c -= b * 3;
+    EXPECT_EQ(c, diff);
+    EXPECT_EQ(c.data(), buffer);
+
+    c += c;
+    EXPECT_EQ(c, diff * 2);
+
+    Matrix wrap(1, 1);
+    wrap(0, 0) = std::numeric_limits<int32_t>::max();
+    Matrix one(1, 1);
+    one(0, 0) = 1;
+    wrap += one;
+    EXPECT_EQ(wrap(0, 0), std::numeric_limits<int32_t>::min());
+
+    EXPECT_THROW(c += Matrix(2, 2), std::invalid_argument);
+    EXPECT_THROW(c -= Matrix(200, 191), std::invalid_argument);
+}
+
+TEST(MatrixTest, BinaryRoundTrip) {
+    Matrix a = patternMatrix(37, 21, 15);
+    std::stringstream stream;
+    a.writeBinary(stream);
+    EXPECT_EQ(stream.str().size(), sizeof(matrix_io::Header) + 37 * a.getStride() * sizeof(int32_t));
+    EXPECT_EQ(Matrix::readBinary(stream), a);
+
+    BasicMatrix<double> d(3, 2);
+    d(2, 1) = -0.25;
+    std::string path = ::testing::TempDir() + "matrix_round_trip.bin";
+    d.save(path);
+    EXPECT_EQ(BasicMatrix<double>::load(path), d);
+    EXPECT_THROW(Matrix::load(path), std::runtime_error);
+
+    std::string truncated = stream.str().substr(0, stream.str().size() - 1);
+    std::stringstream broken(truncated);
+    EXPECT_THROW(Matrix::readBinary(broken), std::runtime_error);
+    std::stringstream garbage(std::string(100, 'x'));
+    EXPECT_THROW(Matrix::readBinary(garbage), std::runtime_error);
+    EXPECT_THROW(Matrix::load("/nonexistent/matrix.bin"), std::runtime_error);
+}
+
+TEST(MatrixTest, MappedFile) {
+    Matrix a = patternMatrix(70, 33, 16);
+    std::string path = ::testing::TempDir() + "matrix_mapped.bin";
+    a.save(path);
+
+    MappedMatrix<int32_t> mapped = Matrix::mapFile(path);
+    ASSERT_EQ(mapped.getRows(), 70);
+    ASSERT_EQ(mapped.getCols(), 33);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.data()) % Matrix::kAlignment, 0);
+    EXPECT_EQ(mapped(69, 32), a(69, 32));
+    EXPECT_EQ(mapped.row(5)[7], a(5, 7));
+    EXPECT_THROW(mapped.at(70, 0), std::out_of_range);
+
+    EXPECT_EQ(mapped, a);
+    EXPECT_EQ(a, mapped);
+    Matrix doubled = mapped + a;
+    EXPECT_EQ(doubled, a * 2);
+
+    Matrix b = patternMatrix(33, 20, 17);
+    EXPECT_EQ(mapped.view(), a);
+    EXPECT_EQ(mapped.view() * b.view(), a * b);
+    Matrix product(33, 33);
+    multiplyInto<int32_t>(product.view(), mapped.view().transposed(), a.view());
+    EXPECT_EQ(product, a.transpose() * a);
+    EXPECT_EQ(mapped.block(60, 30, 10, 3), a.block(60, 30, 10, 3));
+
+    EXPECT_THROW(BasicMatrix<float>::mapFile(path), std::runtime_error);
+    EXPECT_THROW(Matrix::mapFile("/nonexistent/matrix.bin"), std::system_error);
+
+    std::string short_path = ::testing::TempDir() + "matrix_mapped_short.bin";
+    {
+        std::ofstream out(short_path, std::ios::binary);
+        std::stringstream full;
+        a.writeBinary(full);
+        out << full.str().substr(0, 100);
+    }
+    EXPECT_THROW(Matrix::mapFile(short_path), std::runtime_error);
+}
+
+TEST(MatrixViewTest, BlocksRowsColumnsAndTransposes) {
+    Matrix a = patternMatrix(6, 5, 17);
+    const Matrix& ca = a;
+
+    MatrixView<const int32_t> block = ca.block(1, 2, 3, 2);
+    EXPECT_EQ(block.getRows(), 3);
+    EXPECT_EQ(block.getCols(), 2);
+    EXPECT_EQ(block(2, 1), a(3, 3));
+    EXPECT_EQ(block.data(), &a(1, 2));
+
+    MatrixView<int32_t> col = a.view().colView(4);
+    EXPECT_EQ(col.getRows(), 6);
+    EXPECT_EQ(col(5, 0), a(5, 4));
+    EXPECT_EQ(a.view().rowView(3).at(0, 1), a(3, 1));
+
+    Matrix t = a.view().transposed();
+    EXPECT_EQ(t, a.transpose());
+    EXPECT_EQ(a.view().transposed().transposed(), a);
+
+    EXPECT_THROW(a.block(4, 0, 3, 1), std::out_of_range);
+    EXPECT_THROW(a.block(0, 5, 1, 1), std::out_of_range);
+    EXPECT_NO_THROW(a.block(6, 5, 0, 0));
+    EXPECT_THROW(block.at(3, 0), std::out_of_range);
+}
+
+TEST(MatrixViewTest, WritesThroughViews) {
+    Matrix a(4, 4);
+    Matrix ones(2, 2);
+    ones(0, 0) = ones(0, 1) = ones(1, 0) = ones(1, 1) = 1;
+
+    a.block(1, 1, 2, 2) = ones * 3;
+    a.block(1, 1, 2, 2) += ones;
+    a.view().colView(0) = a.view().colView(1);
+    a.view().rowView(3) -= a.view().rowView(1);
+    a.block(0, 2, 2, 2) *= 2;
+
+    Matrix expected(4, 4);
+    expected(1, 0) = 4; expected(1, 1) = 4; expected(1, 2) = 8;
+    expected(2, 0) = 4; expected(2, 1) = 4; expected(2, 2) = 4;
+    expected(3, 0) = -4; expected(3, 1) = -4; expected(3, 2) = -4;
+    EXPECT_EQ(a, expected);
+
+    Matrix square = patternMatrix(40, 40, 18);
+    Matrix transposed = square.transpose();
+    square = square.view().transposed();
+    EXPECT_EQ(square, transposed);
+    square.view() += square.view().transposed();
+    EXPECT_EQ(square, transposed + transposed.transpose());
+
+    EXPECT_THROW(a.block(0, 0, 2, 2) = Matrix(3, 3), std::invalid_argument);
+}
+
+TEST(MatrixViewTest, SelfAliasingAssignment) {
+    const Matrix original = patternMatrix(40, 40, 19);
+    const Matrix transposed = original.transpose();
+
+    Matrix m = original;
+    m.view().transposed() = m;
+    EXPECT_EQ(m, transposed);
+
+    m = original;
+    m.view().transposed() += m;
+    EXPECT_EQ(m, original + transposed);
+
+    m = original;
+    m.view().transposed() -= lazyScale(m, 2);
+    EXPECT_EQ(m, original - transposed * 2);
+
+    m = original;
+    m = lazyAdd(m.view().transposed(), m);
+    EXPECT_EQ(m, original + transposed);
+
+    m = original;
+    m += m.view().transposed();
+    EXPECT_EQ(m, original + transposed);
+
+    m = original;
+    m.block(1, 1, 39, 39) = m.block(0, 0, 39, 39);
+    Matrix shifted = original;
+    shifted.block(1, 1, 39, 39) = original.block(0, 0, 39, 39);
+    EXPECT_EQ(m, shifted);
+
+    m = original;
+    m.block(0, 0, 39, 39) += m.block(1, 1, 39, 39);
+    shifted = original;
+    shifted.block(0, 0, 39, 39) += original.block(1, 1, 39, 39);
+    EXPECT_EQ(m, shifted);
+
+    m = original;
+    m.block(0, 1, 40, 39) = lazyAdd(m.block(0, 0, 40, 39), m.block(0, 1, 40, 39));
+    shifted = original;
+    shifted.block(0, 1, 40, 39) = original.block(0, 0, 40, 39) + original.block(0, 1, 40, 39);
+    EXPECT_EQ(m, shifted);
+}
+
+TEST(MatrixViewTest, ProductsOnViews) {
+    Matrix a = patternMatrix(90, 70, 19);
+    Matrix b = patternMatrix(90, 60, 20);
+
+    Matrix at = a.transpose();
+    EXPECT_EQ(a.view().transposed() * b.view(), at * b);
+
+    Matrix sub = a.block(10, 5, 40, 30) * b.block(20, 7, 30, 25);
+    Matrix a_copy = a.block(10, 5, 40, 30);
+    Matrix b_copy = b.block(20, 7, 30, 25);
+    EXPECT_EQ(sub, a_copy * b_copy);
+
+    Matrix c(80, 80);
+    multiplyInto(c.block(5, 10, 40, 25), a.block(10, 5, 40, 30), b.block(20, 7, 30, 25));
+    EXPECT_EQ(c.block(5, 10, 40, 25), sub);
+    EXPECT_EQ(c(0, 0), 0);
+
+    multiplyInto(c.block(0, 0, 25, 40).transposed(), a.block(10, 5, 40, 30), b.block(20, 7, 30, 25));
+    EXPECT_EQ(c.block(0, 0, 25, 40), sub.transpose());
+
+    BasicMatrix<double> d(30, 20);
+    for (size_t i = 0; i < 30; ++i)
+        for (size_t j = 0; j < 20; ++j)
+            d(i, j) = 0.5 * static_cast<double>((i * 3 + j) % 7);
+    BasicMatrix<double> dt = d.transpose();
+    EXPECT_EQ(d.view().transposed() * d.view(), dt * d);
+
+    Matrix square = patternMatrix(32, 32, 21);
+    Matrix expected = square * square;
+    multiplyInto(square.view(), square.view(), square.view());
+    EXPECT_EQ(square, expected);
+
+    EXPECT_THROW(multiplyInto(c.view(), a.view(), b.view()), std::invalid_argument);
+}
+
+TEST(MatrixTest, OverflowPolicies) {
+    const int32_t max = std::numeric_limits<int32_t>::max();
+    const int32_t min = std::numeric_limits<int32_t>::min();
+
+    // 300 x 300 идёт через пул потоков, 21 столбец даёт хвост после векторных итераций
+    for (size_t cols : {size_t(21), size_t(300)}) {
+        Matrix a = patternMatrix(300, cols, 22);
+        Matrix b = patternMatrix(300, cols, 23);
+        EXPECT_EQ(a.add(b, Overflow::Checked), a + b);
+        EXPECT_EQ(a.subtract(b, Overflow::Saturate), a - b);
+        Matrix scaled = a;
+        scaled.scale(-7, Overflow::Checked);
+        EXPECT_EQ(scaled, a * -7);
+
+        a(299, cols - 1) = max - 1;
+        b(299, cols - 1) = 5;
+        a(0, 0) = min + 2;
+        b(0, 0) = -3;
+        Matrix wrapped = a + b;
+        EXPECT_EQ(a.add(b, Overflow::Wrap), wrapped);
+
+        Matrix saturated = a.add(b, Overflow::Saturate);
+        EXPECT_EQ(saturated(299, cols - 1), max);
+        EXPECT_EQ(saturated(0, 0), min);
+        EXPECT_EQ(saturated(1, 1), wrapped(1, 1));
+        EXPECT_THROW(a.add(b, Overflow::Checked), std::overflow_error);
+
+        Matrix diff = a.subtract(b * -1, Overflow::Saturate);
+        EXPECT_EQ(diff, saturated);
+        EXPECT_THROW(a.subtract(b * -1, Overflow::Checked), std::overflow_error);
+
+        Matrix c = a;
+        EXPECT_THROW(c.scale(2, Overflow::Checked), std::overflow_error);
+        EXPECT_EQ(c, a);
+        c.scale(-2, Overflow::Saturate);
+        EXPECT_EQ(c(299, cols - 1), min);
+        EXPECT_EQ(c(0, 0), max);
+        EXPECT_EQ(c(5, 3), a(5, 3) * -2);
+    }
+
+    int32_t x[] = {max, min, 7, -9, max / 3};
+    int32_t y[5];
+    EXPECT_TRUE(overflow_kernel::scale<int32_t>(x, 4, y, 5, true));
+    EXPECT_EQ(y[0], max);
+    EXPECT_EQ(y[1], min);
+    EXPECT_EQ(y[2], 28);
+    EXPECT_EQ(y[4], max);
+    EXPECT_FALSE(overflow_kernel::add<int32_t>(x + 2, x + 3, y, 2, false));
+
+    BasicMatrix<int64_t> w(2, 2);
+    w(0, 0) = std::numeric_limits<int64_t>::max();
+    w(1, 1) = -5;
+    BasicMatrix<int64_t> saturated = w.add(w, Overflow::Saturate);
+    EXPECT_EQ(saturated(0, 0), std::numeric_limits<int64_t>::max());
+    EXPECT_EQ(saturated(1, 1), -10);
+    EXPECT_THROW(w.scale(3, Overflow::Checked), std::overflow_error);
+
+    EXPECT_THROW(Matrix(2, 2).add(Matrix(2, 3), Overflow::Wrap), std::invalid_argument);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,157 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_queue = 0;
+
+std::unique_ptr<ThreadPool>& globalPool() {
+    static std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>();
+    return pool;
+}
+
+}
+
+ThreadPool::ThreadPool(size_t threads)
+    : _pending(0), _stop(false) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t workers = threads - 1;
+    for (size_t i = 0; i < workers; ++i)
+        _queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < workers; ++i)
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+}
+
+size_t ThreadPool::size() const noexcept {
+    return _workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             const std::function<void(size_t, size_t)>& fn) {
+    if (begin >= end) return;
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = std::min((end - begin + grain - 1) / grain, size() * 4);
+    if (chunks <= 1 || _workers.empty()) {
+        fn(begin, end);
+        return;
+    }
+
+    struct Batch {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    } batch;
+    batch.remaining = chunks;
+
+    size_t step = (end - begin) / chunks, extra = (end - begin) % chunks;
+    size_t lo = begin;
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t hi = lo + step + (c < extra ? 1 : 0);
+        try {
+            push(c % _queues.size(), [&batch, &fn, lo, hi]() {
+                std::exception_ptr error;
+                try {
+                    fn(lo, hi);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(batch.mutex);
+                if (error && !batch.error) batch.error = error;
+                if (batch.remaining.fetch_sub(1) == 1) batch.done.notify_all();
+            });
+        } catch (...) {
+            // Поставленные задачи ссылаются на batch и fn, поэтому их нужно дождаться, прежде чем бросать
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            if (!batch.error) batch.error = std::current_exception();
+            batch.remaining.fetch_sub(chunks - c);
+            break;
+        }
+        lo = hi;
+    }
+
+    size_t start = t_pool == this ? t_queue : 0;
+    Task task;
+    while (batch.remaining.load() > 0) {
+        if (trySteal(start, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(batch.mutex);
+        batch.done.wait(lock, [&batch]() { return batch.remaining.load() == 0; });
+    }
+    // Последняя задача могла ещё не отпустить мьютекс, а batch живёт на стеке
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (batch.error) std::rethrow_exception(batch.error);
+}
+
+ThreadPool& ThreadPool::global() {
+    return *globalPool();
+}
+
+void ThreadPool::setGlobalThreads(size_t threads) {
+    globalPool() = std::make_unique<ThreadPool>(threads);
+}
+
+void ThreadPool::push(size_t queue, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(_queues[queue]->mutex);
+        _queues[queue]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_pending;
+    }
+    _cv.notify_one();
+}
+
+bool ThreadPool::tryPop(size_t queue, Task& task) {
+    std::lock_guard<std::mutex> lock(_queues[queue]->mutex);
+    if (_queues[queue]->tasks.empty()) return false;
+    task = std::move(_queues[queue]->tasks.back());
+    _queues[queue]->tasks.pop_back();
+    --_pending;
+    return true;
+}
+
+bool ThreadPool::trySteal(size_t start, Task& task) {
+    for (size_t i = 0; i < _queues.size(); ++i) {
+        Queue& queue = *_queues[(start + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --_pending;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    t_pool = this;
+    t_queue = index;
+    Task task;
+    while (true) {
+        if (tryPop(index, task) || trySteal(index + 1, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]() { return _stop || _pending.load() > 0; });
+        if (_stop) return;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул с очередью на каждый поток: поток берёт задачи с хвоста своей очереди,
+// а когда она пуста - крадёт с головы чужих. Вызывающий parallelFor поток тоже выполняет задачи,
+// поэтому вложенные parallelFor не приводят к взаимоблокировке
+class ThreadPool {
+public:
+    // threads - общее число потоков вместе с вызывающим, 0 - по числу ядер
+    explicit ThreadPool(size_t threads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    size_t size() const noexcept;
+
+    // Делит [begin, end) на куски не меньше grain и вызывает fn(lo, hi) для каждого, ждёт завершения всех.
+    // Первое выброшенное задачей исключение пробрасывается вызывающему
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    static ThreadPool& global();
+    // Пересоздаёт общий пул; нельзя вызывать, пока общий пул используется
+    static void setGlobalThreads(size_t threads);
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(size_t queue, Task task);
+    bool tryPop(size_t queue, Task& task);
+    bool trySteal(size_t start, Task& task);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::atomic<size_t> _pending;
+    bool _stop;
+};
+
+#endif
@@ -1,146 +1,243 @@
 #include "BigInt.h"
+#include "bigint_mul.h"
+#include <vector>
+
+namespace {
+
+// Больше этого числа разрядов произведение не держится в буфере потока, чтобы он не разрастался навсегда
+constexpr size_t SCRATCH_LIMBS = size_t(1) << 16;
+
+}
+
+void BigInt::reserve(size_t new_capacity) {
+    if (new_capacity <= capacity) return;
+    uint32_t* new_limbs = new uint32_t[new_capacity];
+    std::memcpy(new_limbs, limbs, size * sizeof(uint32_t));
+    if (!is_inline()) delete[] limbs;
+
+    limbs = new_limbs;
+    capacity = new_capacity;
+}
 
 void BigInt::resize(size_t new_size) {
-    if (new_size == size) return;
-    char* new_digits = new char[new_size]();
-    if (new_digits) {
-        if (digits) {
-            size_t copy_size = std::min(size, new_size);
-            std::memcpy(new_digits, digits, copy_size);
-            delete[] digits;
-        }
-        
-        digits = new_digits;
-        size = new_size;
-    }
+    // Рост хотя бы вдвое, чтобы последовательность прибавлений выделяла память O(log n) раз
+    if (new_size > capacity) reserve(std::max(new_size, 2 * capacity));
+    if (new_size > size) std::fill(limbs + size, limbs + new_size, uint32_t(0));
+    size = new_size;
 }
 
 void BigInt::remove_zeroes() {
     size_t new_size = size;
-    while (new_size > 1 && digits[new_size - 1] == 0) --new_size;
-    if (new_size != size) resize(new_size);
-    if (size == 1 && digits[0] == 0) sign = false;
+    while (new_size > 1 && limbs[new_size - 1] == 0) --new_size;
+    size = new_size;
+    if (is_zero()) sign = false;
 }
 
-int BigInt::compare_abs(const BigInt& other) const {
-    if (size != other.size) return size > other.size ? 1 : -1;
-    for (int i = size - 1; i >= 0; --i) {
-        if (digits[i] != other.digits[i])
-            return digits[i] > other.digits[i] ? 1 : -1;
+void BigInt::steal(BigInt& other) noexcept {
+    if (other.is_inline()) {
+        std::memcpy(small, other.small, other.size * sizeof(uint32_t));
+        limbs = small;
+        capacity = INLINE_LIMBS;
+    } else {
+        limbs = other.limbs;
+        capacity = other.capacity;
+    }
+    size = other.size;
+    sign = other.sign;
+
+    other.limbs = other.small;
+    other.capacity = INLINE_LIMBS;
+    other.small[0] = 0;
+    other.size = 1;
+    other.sign = false;
+}
+
+void BigInt::negate() {
+    if (!is_zero()) sign = !sign;
+}
+
+int BigInt::compare_abs(const uint32_t* other, size_t other_size) const {
+    if (size != other_size) return size > other_size ? 1 : -1;
+    for (size_t i = size; i > 0; --i) {
+        if (limbs[i - 1] != other[i - 1])
+            return limbs[i - 1] > other[i - 1] ? 1 : -1;
     }
     return 0;
 }
 
-void BigInt::add_abs(const BigInt& other) {
-    size_t max_size = std::max(size, other.size) + 1;
+void BigInt::add_abs(const uint32_t* other, size_t other_size) {
+    bool self = other == limbs;
+    size_t old_size = size;
+    size_t max_size = std::max(size, other_size) + 1;
     resize(max_size);
-    int carry = 0;
+    if (self) other = limbs;
+    // Сумма двух разрядов и переноса меньше 2 * 10^9 и помещается в uint32_t
+    uint32_t carry = 0;
     for (size_t i = 0; i < max_size; ++i) {
-        int sum = carry;
-        if (i < size) sum += digits[i];
-        if (i < other.size) sum += other.digits[i];
-        
-        digits[i] = sum % 10;
-        carry = sum / 10;
+        uint32_t sum = carry;
+        if (i < old_size) sum += limbs[i];
+        if (i < other_size) sum += other[i];
+
+        carry = sum >= BASE;
+        limbs[i] = carry ? sum - BASE : sum;
     }
     remove_zeroes();
 }
 
-void BigInt::subtract_abs(const BigInt& other) {
-    int borrow = 0;
+void BigInt::subtract_abs(const uint32_t* other, size_t other_size) {
+    uint32_t borrow = 0;
     for (size_t i = 0; i < size; ++i) {
-        int diff = digits[i] - borrow;
-        if (i < other.size) diff -= other.digits[i];
-        if (diff < 0) {
-            borrow = 1;
-            diff += 10;
-        } else borrow = 0;
-        digits[i] = diff;
+        uint32_t sub = borrow + (i < other_size ? other[i] : 0);
+        borrow = limbs[i] < sub;
+        limbs[i] = borrow ? limbs[i] + BASE - sub : limbs[i] - sub;
+        if (!borrow && i >= other_size) break;
     }
     remove_zeroes();
 }
 
-BigInt::BigInt() : digits(nullptr), size(0), sign(false) {
-    resize(1);
-    digits[0] = 0;
+void BigInt::reverse_subtract_abs(const uint32_t* other, size_t other_size) {
+    resize(other_size);
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t sub = limbs[i] + borrow;
+        borrow = other[i] < sub;
+        limbs[i] = borrow ? other[i] + BASE - sub : other[i] - sub;
+    }
+    remove_zeroes();
 }
 
-BigInt::BigInt(int32_t val) : digits(nullptr), size(0), sign(val < 0) {
-    uint32_t abs_val = std::abs(static_cast<int64_t>(val));
-    if (abs_val == 0) {
+void BigInt::add_signed(const uint32_t* other, size_t other_size, bool other_sign) {
+    if (sign == other_sign) {
+        add_abs(other, other_size);
+        return;
+    }
+    int cmp = compare_abs(other, other_size);
+    if (cmp > 0) {
+        subtract_abs(other, other_size);
+    } else if (cmp < 0) {
+        reverse_subtract_abs(other, other_size);
+        sign = other_sign;
+    } else {
         resize(1);
-        digits[0] = 0;
+        limbs[0] = 0;
         sign = false;
-        return;
     }
+}
 
-    uint32_t temp = abs_val;
+size_t BigInt::split(uint64_t abs, uint32_t* out) {
     size_t count = 0;
-    while (temp > 0) {
-        temp /= 10;
-        ++count;
-    }
-    resize(count);
-    
-    temp = abs_val;
-    for (size_t i = 0; i < size; ++i) {
-        digits[i] = temp % 10;
-        temp /= 10;
-    }
+    do {
+        out[count++] = static_cast<uint32_t>(abs % BASE);
+        abs /= BASE;
+    } while (abs > 0);
+    return count;
 }
 
-BigInt::BigInt(const std::string& str) : digits(nullptr), size(0), sign(false) {
-    if (str.empty()) {
-        resize(1);
-        digits[0] = 0;
-        return;
+void BigInt::assign_int(uint64_t abs, bool neg) {
+    size = split(abs, limbs);
+    sign = neg;
+}
+
+void BigInt::add_int(uint64_t abs, bool neg) {
+    uint32_t other[MAX_INT_LIMBS];
+    size_t other_size = split(abs, other);
+    add_signed(other, other_size, neg && abs != 0);
+}
+
+// Разряд результата k = limbs[k] * v[0] + limbs[k - 1] * v[1] + limbs[k - 2] * v[2] + перенос, так что
+// умножение идёт на месте, если помнить два предыдущих исходных разряда. Сумма меньше 3 * 10^18 + 3 * 10^9
+void BigInt::multiply_int(uint64_t abs, bool neg) {
+    uint64_t v[MAX_INT_LIMBS] = {abs % BASE, abs / BASE % BASE, abs / BASE / BASE};
+    size_t other_size = v[2] ? 3 : v[1] ? 2 : 1;
+    resize(size + other_size);
+
+    uint64_t carry = 0;
+    uint64_t prev1 = 0;
+    uint64_t prev2 = 0;
+    for (size_t k = 0; k < size; ++k) {
+        uint64_t cur = limbs[k];
+        uint64_t acc = cur * v[0] + prev1 * v[1] + prev2 * v[2] + carry;
+        limbs[k] = static_cast<uint32_t>(acc % BASE);
+        carry = acc / BASE;
+        prev2 = prev1;
+        prev1 = cur;
     }
+    sign = sign != neg;
+    remove_zeroes();
+}
+
+std::strong_ordering BigInt::compare_int(uint64_t abs, bool neg) const {
+    if (sign != neg)
+        return sign ? std::strong_ordering::less : std::strong_ordering::greater;
+    uint32_t other[MAX_INT_LIMBS];
+    size_t other_size = split(abs, other);
+    int cmp = compare_abs(other, other_size);
+    if (sign) cmp = -cmp;
+    return cmp < 0 ? std::strong_ordering::less : cmp > 0 ? std::strong_ordering::greater : std::strong_ordering::equal;
+}
+
+BigInt::BigInt() : limbs(small), size(1), capacity(INLINE_LIMBS), sign(false) {
+    small[0] = 0;
+}
+
+BigInt::BigInt(const std::string& str) : limbs(small), size(0), capacity(INLINE_LIMBS), sign(false) {
     size_t start = 0;
-    if (str[0] == '-') {
+    if (!str.empty() && str[0] == '-') {
         sign = true;
         start = 1;
-    } else if (str[0] == '+') start = 1;
+    } else if (!str.empty() && str[0] == '+') start = 1;
 
     while (start < str.length() && str[start] == '0') ++start;
 
     if (start == str.length()) {
         resize(1);
-        digits[0] = 0;
         sign = false;
         return;
     }
 
-    size_t num_digits = str.length() - start;
-    resize(num_digits);
-    for (size_t i = 0; i < size; i++) {
-        char c = str[str.length() - 1 - i];
-        if (c < '0' || c > '9') {
+    for (size_t i = start; i < str.length(); ++i) {
+        if (str[i] < '0' || str[i] > '9') {
             throw std::invalid_argument("Invalid char");
         }
-        digits[i] = c - '0';
+    }
+
+    // Разряды собираются по 9 цифр с конца строки, старший разряд может быть неполным
+    size_t num_digits = str.length() - start;
+    resize((num_digits + BASE_DIGITS - 1) / BASE_DIGITS);
+    size_t end = str.length();
+    for (size_t i = 0; i < size; ++i) {
+        size_t begin = end > start + BASE_DIGITS ? end - BASE_DIGITS : start;
+        uint32_t limb = 0;
+        for (size_t j = begin; j < end; ++j)
+            limb = limb * 10 + static_cast<uint32_t>(str[j] - '0');
+        limbs[i] = limb;
+        end = begin;
     }
     remove_zeroes();
 }
 
-BigInt::BigInt(const BigInt& other) : digits(nullptr), size(0), sign(other.sign) {
-    resize(other.size);
-    std::memcpy(digits, other.digits, size);
+BigInt::BigInt(const BigInt& other) : BigInt(other, other.size) {}
+
+BigInt::BigInt(const BigInt& other, size_t min_capacity) : limbs(small), size(0), capacity(INLINE_LIMBS), sign(other.sign) {
+    reserve(std::max(other.size, min_capacity));
+    std::memcpy(limbs, other.limbs, other.size * sizeof(uint32_t));
+    size = other.size;
 }
 
-BigInt::BigInt(BigInt&& other) noexcept : digits(other.digits), size(other.size), sign(other.sign) {
-    other.digits = nullptr;
-    other.size = 0;
-    other.sign = false;
+BigInt::BigInt(BigInt&& other) noexcept : limbs(small), size(0), capacity(INLINE_LIMBS), sign(false) {
+    steal(other);
 }
 
 BigInt::~BigInt() {
-    delete[] digits;
+    if (!is_inline()) delete[] limbs;
 }
 
 BigInt& BigInt::operator=(const BigInt& other) {
     if (this != &other) {
-        resize(other.size);
-        std::memcpy(digits, other.digits, size);
+        size = 0;
+        reserve(other.size);
+        std::memcpy(limbs, other.limbs, other.size * sizeof(uint32_t));
+        size = other.size;
         sign = other.sign;
     }
     return *this;
@@ -148,91 +245,123 @@ BigInt& BigInt::operator=(const BigInt& other) {
 
 BigInt& BigInt::operator=(BigInt&& other) noexcept {
     if (this != &other) {
-        delete[] digits;
-        
-        digits = other.digits;
-        size = other.size;
-        sign = other.sign;
-        
-        other.digits = nullptr;
-        other.size = 0;
-        other.sign = false;
+        if (!is_inline()) delete[] limbs;
+        steal(other);
     }
     return *this;
 }
 
-BigInt BigInt::operator+(const BigInt& other) const {
-    if (sign == other.sign) {
-        BigInt result = *this;
-        result.add_abs(other);
-        result.sign = sign;
-        return result;
+BigInt& BigInt::operator+=(const BigInt& other) {
+    add_signed(other.limbs, other.size, other.sign);
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& other) {
+    add_signed(other.limbs, other.size, !other.sign && !other.is_zero());
+    return *this;
+}
+
+// Произведение не может писать поверх операндов. Если памяти хватает, небольшое произведение считается
+// в буфер потока и копируется на место, иначе - в новую память, которая заменяет старую
+BigInt& BigInt::operator*=(const BigInt& other) {
+    if (is_zero() || other.is_zero()) {
+        resize(1);
+        limbs[0] = 0;
+        sign = false;
+        return *this;
+    }
+
+    size_t result_size = size + other.size;
+    if (result_size <= capacity && result_size <= SCRATCH_LIMBS) {
+        thread_local std::vector<uint32_t> scratch;
+        if (scratch.size() < result_size) scratch.resize(result_size);
+        bigint_mul::multiply(limbs, size, other.limbs, other.size, scratch.data());
+        std::memcpy(limbs, scratch.data(), result_size * sizeof(uint32_t));
     } else {
-        int cmp = compare_abs(other);
-        if (cmp == 0) {
-            return BigInt(0);
-        }
-        
-        BigInt result;
-        if (cmp > 0) {
-            result = *this;
-            result.subtract_abs(other);
-            result.sign = sign;
-        } else {
-            result = other;
-            result.subtract_abs(*this);
-            result.sign = other.sign;
-        }
-        return result;
+        size_t new_capacity = result_size <= capacity ? capacity : std::max(result_size, 2 * capacity);
+        uint32_t* result = new uint32_t[new_capacity];
+        bigint_mul::multiply(limbs, size, other.limbs, other.size, result);
+        if (!is_inline()) delete[] limbs;
+        limbs = result;
+        capacity = new_capacity;
     }
+    size = result_size;
+    sign = sign != other.sign;
+    remove_zeroes();
+    return *this;
 }
 
-BigInt BigInt::operator-(const BigInt& other) const {
-    return *this + (-other);
+BigInt BigInt::operator+(const BigInt& other) const& {
+    BigInt result(*this, std::max(size, other.size) + 1);
+    result += other;
+    return result;
+}
+
+BigInt BigInt::operator+(const BigInt& other) && {
+    *this += other;
+    return std::move(*this);
+}
+
+BigInt BigInt::operator+(BigInt&& other) const& {
+    other += *this;
+    return std::move(other);
+}
+
+BigInt BigInt::operator+(BigInt&& other) && {
+    *this += other;
+    return std::move(*this);
+}
+
+BigInt BigInt::operator-(const BigInt& other) const& {
+    BigInt result(*this, std::max(size, other.size) + 1);
+    result -= other;
+    return result;
+}
+
+BigInt BigInt::operator-(const BigInt& other) && {
+    *this -= other;
+    return std::move(*this);
+}
+
+BigInt BigInt::operator-(BigInt&& other) const& {
+    other -= *this;
+    other.negate();
+    return std::move(other);
+}
+
+BigInt BigInt::operator-(BigInt&& other) && {
+    *this -= other;
+    return std::move(*this);
 }
 
 BigInt BigInt::operator*(const BigInt& other) const {
-    if (*this == BigInt(0) || other == BigInt(0)) return BigInt(0);
-    
+    if (is_zero() || other.is_zero()) return BigInt();
+
+    static_assert(BASE == bigint_mul::BASE, "Limb bases differ");
     BigInt result;
     result.resize(size + other.size);
-    for (size_t i = 0; i < size; ++i) {
-        int carry = 0;
-        for (size_t j = 0; j < other.size || carry; ++j) {
-            long long product = result.digits[i + j] + digits[i] * (j < other.size ? other.digits[j] : 0) + carry;
-            result.digits[i + j] = product % 10;
-            carry = product / 10;
-        }
-    }
-    
+    bigint_mul::multiply(limbs, size, other.limbs, other.size, result.limbs);
+
     result.sign = sign != other.sign;
     result.remove_zeroes();
     return result;
 }
 
-BigInt BigInt::operator-() const {
+BigInt BigInt::operator-() const& {
     BigInt result = *this;
-    if (result != BigInt(0))
-        result.sign = !result.sign;
+    result.negate();
     return result;
 }
 
-BigInt BigInt::operator+(int32_t other) const {
-    return *this + BigInt(other);
-}
-
-BigInt BigInt::operator-(int32_t other) const {
-    return *this - BigInt(other);
-}
-
-BigInt BigInt::operator*(int32_t other) const {
-    return *this * BigInt(other);
+BigInt BigInt::operator-() && {
+    negate();
+    return std::move(*this);
 }
 
 std::strong_ordering BigInt::operator<=>(const BigInt& other) const {
     if (sign != other.sign)
         return sign ? std::strong_ordering::less : std::strong_ordering::greater;
-    int cmp = compare_abs(other);
+    int cmp = compare_abs(other.limbs, other.size);
     if (cmp == 0) return std::strong_ordering::equal;
     if (sign) return cmp > 0 ? std::strong_ordering::less : std::strong_ordering::greater;
     else return cmp > 0 ? std::strong_ordering::greater : std::strong_ordering::less;
@@ -240,17 +369,25 @@ std::strong_ordering BigInt::operator<=>(const BigInt& other) const {
 
 bool BigInt::operator==(const BigInt& other) const {
     if (sign != other.sign || size != other.size) return false;
-    for (size_t i = 0; i < size; ++i)
-        if (digits[i] != other.digits[i])
-            return false;
-    return true;
+    return std::equal(limbs, limbs + size, other.limbs);
 }
 
 std::ostream& operator<<(std::ostream& os, const BigInt& num) {
-    if (num.sign && !(num.size == 1 && num.digits[0] == 0)) os << '-';
-    
-    for (size_t i = num.size; i > 0; --i)
-        os << static_cast<char>(num.digits[i - 1] + '0');
-    
-    return os;
-}
\ No newline at end of file
+    std::string out;
+    out.reserve(num.size * BigInt::BASE_DIGITS + 1);
+    if (num.sign && !num.is_zero()) out += '-';
+
+    // Старший разряд печатается как есть, остальные дополняются ведущими нулями до 9 цифр
+    out += std::to_string(num.limbs[num.size - 1]);
+    for (size_t i = num.size - 1; i > 0; --i) {
+        uint32_t limb = num.limbs[i - 1];
+        char buf[BigInt::BASE_DIGITS];
+        for (size_t j = BigInt::BASE_DIGITS; j > 0; --j) {
+            buf[j - 1] = static_cast<char>('0' + limb % 10);
+            limb /= 10;
+        }
+        out.append(buf, BigInt::BASE_DIGITS);
+    }
+
+    return os << out;
+}
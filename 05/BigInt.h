@@ -7,11 +7,21 @@
 #include <string>
 #include <algorithm>
 #include <compare>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+// Целые типы, которые смешиваются с BigInt; bool и символьные типы числами не считаются
+template<class T>
+concept BigIntInteger = std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char> &&
+    !std::same_as<T, signed char> && !std::same_as<T, unsigned char> && !std::same_as<T, wchar_t> &&
+    !std::same_as<T, char8_t> && !std::same_as<T, char16_t> && !std::same_as<T, char32_t>;
 
 class BigInt {
 public:
     BigInt();
-    BigInt(int32_t val);
+    template<BigIntInteger T>
+    BigInt(T val);
     BigInt(const std::string& str);
     BigInt(const BigInt& other);
     BigInt(BigInt&& other) noexcept;
@@ -21,31 +31,188 @@ public:
     BigInt& operator=(const BigInt& other);
     BigInt& operator=(BigInt&& other) noexcept;
 
-    BigInt operator+(const BigInt& other) const;
-    BigInt operator-(const BigInt& other) const;
+    BigInt& operator+=(const BigInt& other);
+    BigInt& operator-=(const BigInt& other);
+    BigInt& operator*=(const BigInt& other);
+
+    // Перегрузки для временных операндов записывают результат в их память вместо новой
+    BigInt operator+(const BigInt& other) const&;
+    BigInt operator+(const BigInt& other) &&;
+    BigInt operator+(BigInt&& other) const&;
+    BigInt operator+(BigInt&& other) &&;
+    BigInt operator-(const BigInt& other) const&;
+    BigInt operator-(const BigInt& other) &&;
+    BigInt operator-(BigInt&& other) const&;
+    BigInt operator-(BigInt&& other) &&;
     BigInt operator*(const BigInt& other) const;
-    BigInt operator-() const;
+    BigInt operator-() const&;
+    BigInt operator-() &&;
+
+    // Смешанные операции со встроенными целыми не создают временный BigInt: значение раскладывается
+    // в разряды на стеке, и память выделяется, только если результату не хватает текущей
+    template<BigIntInteger T>
+    BigInt& operator+=(T other);
+    template<BigIntInteger T>
+    BigInt& operator-=(T other);
+    template<BigIntInteger T>
+    BigInt& operator*=(T other);
 
-    BigInt operator+(int32_t other) const;
-    BigInt operator-(int32_t other) const;
-    BigInt operator*(int32_t other) const;
+    template<BigIntInteger T>
+    BigInt operator+(T other) const&;
+    template<BigIntInteger T>
+    BigInt operator+(T other) &&;
+    template<BigIntInteger T>
+    BigInt operator-(T other) const&;
+    template<BigIntInteger T>
+    BigInt operator-(T other) &&;
+    template<BigIntInteger T>
+    BigInt operator*(T other) const&;
+    template<BigIntInteger T>
+    BigInt operator*(T other) &&;
 
     std::strong_ordering operator<=>(const BigInt& other) const;
     bool operator==(const BigInt& other) const;
+    template<BigIntInteger T>
+    std::strong_ordering operator<=>(T other) const;
+    template<BigIntInteger T>
+    bool operator==(T other) const;
+
+    bool is_zero() const { return size == 1 && limbs[0] == 0; }
+    bool is_negative() const { return sign; }
+    bool is_positive() const { return !sign && !is_zero(); }
 
     friend std::ostream& operator<<(std::ostream& os, const BigInt& num);
 
 private:
+    // Число хранится по модулю в системе счисления с основанием 10^9: по 9 десятичных цифр в uint32_t,
+    // младшие разряды первыми. Основание - степень десяти, поэтому перевод в строку и обратно линейный
+    static constexpr uint32_t BASE = 1000000000;
+    static constexpr size_t BASE_DIGITS = 9;
+    // Числа до 4 разрядов (меньше 10^36, в том числе любые 64-битные) хранятся внутри объекта без кучи
+    static constexpr size_t INLINE_LIMBS = 4;
+
+    // Наибольшее число разрядов 64-битного значения: 2^64 < 10^27
+    static constexpr size_t MAX_INT_LIMBS = 3;
+
+    template<BigIntInteger T>
+    static bool is_negative_value(T val) {
+        if constexpr (std::is_signed_v<T>) return val < 0;
+        else return false;
+    }
+
+    // Модуль целого без переполнения на минимальном значении
+    template<BigIntInteger T>
+    static uint64_t abs_value(T val) {
+        return is_negative_value(val) ? uint64_t(0) - static_cast<uint64_t>(val) : static_cast<uint64_t>(val);
+    }
+
+    // Раскладывает abs в разряды, возвращает их число (не меньше одного)
+    static size_t split(uint64_t abs, uint32_t* out);
+
+    void assign_int(uint64_t abs, bool neg);
+    void add_int(uint64_t abs, bool neg);
+    void multiply_int(uint64_t abs, bool neg);
+    std::strong_ordering compare_int(uint64_t abs, bool neg) const;
+
+    // Копия с памятью не меньше чем на min_capacity разрядов
+    BigInt(const BigInt& other, size_t min_capacity);
+
+    // Меняет число разрядов; память перевыделяется, только если new_size больше capacity, и никогда не сжимается
     void resize(size_t new_size);
+    void reserve(size_t new_capacity);
+    bool is_inline() const { return limbs == small; }
+    // Забирает память other (или копирует встроенные разряды), оставляя в other ноль
+    void steal(BigInt& other) noexcept;
     void remove_zeroes();
-    int compare_abs(const BigInt& other) const;
-    void add_abs(const BigInt& other);
-    void subtract_abs(const BigInt& other);
+    void negate();
+    // Операции над модулями принимают разряды второго операнда без ведущих нулей: other может быть
+    // как другим BigInt, так и разложенным на стеке целым
+    int compare_abs(const uint32_t* other, size_t other_size) const;
+    void add_abs(const uint32_t* other, size_t other_size);
+    void subtract_abs(const uint32_t* other, size_t other_size);
+    // |this| = |other| - |this|, требует |other| > |this|
+    void reverse_subtract_abs(const uint32_t* other, size_t other_size);
+    // this += other со знаком other_sign
+    void add_signed(const uint32_t* other, size_t other_size, bool other_sign);
 
 private:
-    char* digits;
+    uint32_t* limbs;
     size_t size;
+    size_t capacity;
     bool sign;
+    uint32_t small[INLINE_LIMBS];
 };
 
+template<BigIntInteger T>
+BigInt::BigInt(T val) : limbs(small), size(0), capacity(INLINE_LIMBS), sign(false) {
+    assign_int(abs_value(val), is_negative_value(val));
+}
+
+template<BigIntInteger T>
+BigInt& BigInt::operator+=(T other) {
+    add_int(abs_value(other), is_negative_value(other));
+    return *this;
+}
+
+template<BigIntInteger T>
+BigInt& BigInt::operator-=(T other) {
+    add_int(abs_value(other), !is_negative_value(other));
+    return *this;
+}
+
+template<BigIntInteger T>
+BigInt& BigInt::operator*=(T other) {
+    multiply_int(abs_value(other), is_negative_value(other));
+    return *this;
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator+(T other) const& {
+    BigInt result(*this, std::max(size, MAX_INT_LIMBS) + 1);
+    result += other;
+    return result;
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator+(T other) && {
+    *this += other;
+    return std::move(*this);
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator-(T other) const& {
+    BigInt result(*this, std::max(size, MAX_INT_LIMBS) + 1);
+    result -= other;
+    return result;
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator-(T other) && {
+    *this -= other;
+    return std::move(*this);
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator*(T other) const& {
+    BigInt result(*this, size + MAX_INT_LIMBS);
+    result *= other;
+    return result;
+}
+
+template<BigIntInteger T>
+BigInt BigInt::operator*(T other) && {
+    *this *= other;
+    return std::move(*this);
+}
+
+template<BigIntInteger T>
+std::strong_ordering BigInt::operator<=>(T other) const {
+    return compare_int(abs_value(other), is_negative_value(other));
+}
+
+template<BigIntInteger T>
+bool BigInt::operator==(T other) const {
+    return compare_int(abs_value(other), is_negative_value(other)) == 0;
+}
+
 #endif
@@ -0,0 +1,90 @@
+#include "BigInt.h"
+#include "bigint_mul.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static volatile uint32_t g_sink = 0;
+
+struct Result {
+    double seconds;
+    size_t iterations;
+};
+
+// Повторяет run, пока суммарное время не превысит kMinSeconds, и берёт лучшее среднее из kRepeats серий
+static const double kMinSeconds = 0.2;
+static const int kRepeats = 3;
+
+template<class Fn>
+static Result Measure(Fn&& run) {
+    Result best{1e100, 0};
+    for (int r = 0; r < kRepeats; ++r) {
+        size_t iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            run();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < kMinSeconds);
+        if (elapsed / iterations < best.seconds) best = Result{elapsed / iterations, iterations};
+    }
+    return best;
+}
+
+static std::vector<uint32_t> RandomLimbs(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint32_t> limbs(count);
+    for (uint32_t& x : limbs) x = static_cast<uint32_t>(rng() % bigint_mul::BASE);
+    limbs.back() = std::max<uint32_t>(limbs.back(), 1);
+    return limbs;
+}
+
+static std::string RandomDigits(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::string str(count, '0');
+    for (char& c : str) c = static_cast<char>('0' + rng() % 10);
+    str[0] = '1';
+    return str;
+}
+
+// Умножение двух чисел по digits десятичных цифр: столбик, Карацуба и Тоом-3 против NTT и operator*,
+// который выбирает алгоритм сам. Последний столбец - во сколько раз NTT быстрее
+static void RunProduct(size_t digits) {
+    size_t limbs = (digits + 8) / 9;
+    std::vector<uint32_t> a = RandomLimbs(limbs, 1);
+    std::vector<uint32_t> b = RandomLimbs(limbs, 2);
+    std::vector<uint32_t> res(2 * limbs);
+    BigInt x(RandomDigits(digits, 3));
+    BigInt y(RandomDigits(digits, 4));
+
+    Result classic = Measure([&]() {
+        bigint_mul::multiplyClassic(a.data(), limbs, b.data(), limbs, res.data());
+        g_sink = res[0];
+    });
+    Result ntt = Measure([&]() {
+        bigint_mul::multiplyNtt(a.data(), limbs, b.data(), limbs, res.data());
+        g_sink = res[0];
+    });
+    Result product = Measure([&]() {
+        BigInt z = x * y;
+        g_sink = z == x ? 1 : 0;
+    });
+    std::printf("%10zu %8zu %12.4f %12.4f %12.4f %8.2f\n", digits, limbs, classic.seconds * 1e3, ntt.seconds * 1e3,
+                product.seconds * 1e3, classic.seconds / ntt.seconds);
+}
+
+// Аргумент: наибольшее число десятичных цифр в операнде
+int main(int argc, char** argv) {
+    size_t max_digits = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::printf("%10s %8s %12s %12s %12s %8s\n", "digits", "limbs", "classic ms", "ntt ms", "operator* ms", "speedup");
+    for (size_t digits = 1000; digits <= max_digits; digits *= 2)
+        RunProduct(digits);
+    RunProduct(max_digits);
+    return 0;
+}
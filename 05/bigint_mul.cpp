@@ -0,0 +1,448 @@
+#include "bigint_mul.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace bigint_mul {
+namespace {
+
+// Стековый распределитель для промежуточных значений рекурсии: память берётся сдвигом указателя
+// и возвращается целиком до отметки, блоки переиспользуются между уровнями рекурсии
+class Arena {
+public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    explicit Arena(size_t bytes) { _blocks.push_back(Block{std::make_unique<std::byte[]>(bytes), bytes}); }
+
+    template<class T>
+    T* allocate(size_t count) {
+        size_t bytes = (count * sizeof(T) + kAlign - 1) / kAlign * kAlign;
+        while (_offset + bytes > _blocks[_current].size) {
+            if (_current + 1 == _blocks.size()) {
+                size_t size = std::max(bytes, 2 * _blocks.back().size);
+                _blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+            }
+            ++_current;
+            _offset = 0;
+        }
+        T* ptr = reinterpret_cast<T*>(_blocks[_current].data.get() + _offset);
+        _offset += bytes;
+        return ptr;
+    }
+
+    Mark mark() const { return Mark{_current, _offset}; }
+
+    void release(Mark mark) {
+        _current = mark.block;
+        _offset = mark.offset;
+    }
+
+private:
+    static constexpr size_t kAlign = alignof(std::max_align_t);
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> _blocks;
+    size_t _current = 0;
+    size_t _offset = 0;
+};
+
+size_t trim(const uint32_t* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) --n;
+    return n;
+}
+
+int compare(const uint32_t* a, size_t n, const uint32_t* b, size_t m) {
+    if (n != m) return n > m ? 1 : -1;
+    for (size_t i = n; i > 0; --i)
+        if (a[i - 1] != b[i - 1]) return a[i - 1] > b[i - 1] ? 1 : -1;
+    return 0;
+}
+
+// res[0 .. n) += a[0 .. m), m <= n; возвращает перенос из старшего разряда
+uint32_t addInto(uint32_t* res, size_t n, const uint32_t* a, size_t m) {
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i < m; ++i) {
+        uint32_t sum = res[i] + a[i] + carry;
+        carry = sum >= BASE;
+        res[i] = carry ? sum - BASE : sum;
+    }
+    for (; carry && i < n; ++i) {
+        carry = res[i] == BASE - 1;
+        res[i] = carry ? 0 : res[i] + 1;
+    }
+    return carry;
+}
+
+// res[0 .. n) -= a[0 .. m), m <= n, res >= a
+void subInto(uint32_t* res, size_t n, const uint32_t* a, size_t m) {
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i < m; ++i) {
+        uint32_t sub = a[i] + borrow;
+        borrow = res[i] < sub;
+        res[i] = borrow ? res[i] + BASE - sub : res[i] - sub;
+    }
+    for (; borrow && i < n; ++i) {
+        borrow = res[i] == 0;
+        res[i] = borrow ? BASE - 1 : res[i] - 1;
+    }
+}
+
+void multiplyRec(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res);
+
+// Произведения разрядов копятся в uint64_t без деления: 18 * (10^9 - 1)^2 плюс перенос меньше 2^64,
+// поэтому столбцы нормализуются один раз на 18 строк. n >= m
+void schoolbook(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    constexpr size_t kRowsPerPass = 18;
+    Arena::Mark mark = arena.mark();
+    uint64_t* acc = arena.allocate<uint64_t>(n + m);
+    std::fill(acc, acc + n + m, uint64_t(0));
+
+    auto normalize = [acc](size_t lo, size_t hi) {
+        uint64_t carry = 0;
+        for (size_t c = lo; c < hi; ++c) {
+            uint64_t v = acc[c] + carry;
+            acc[c] = v % BASE;
+            carry = v / BASE;
+        }
+        return carry;
+    };
+
+    for (size_t j0 = 0; j0 < m; j0 += kRowsPerPass) {
+        size_t j1 = std::min(m, j0 + kRowsPerPass);
+        for (size_t j = j0; j < j1; ++j) {
+            uint64_t y = b[j];
+            uint64_t* row = acc + j;
+            for (size_t i = 0; i < n; ++i) row[i] += y * a[i];
+        }
+        acc[j1 - 1 + n] += normalize(j0, j1 - 1 + n);
+    }
+    normalize(m == 0 ? 0 : m - 1 + n, n + m);
+
+    for (size_t c = 0; c < n + m; ++c) res[c] = static_cast<uint32_t>(acc[c]);
+    arena.release(mark);
+}
+
+// Длинный операнд режется на куски длины m, произведения кусков складываются со сдвигом. n >= 2m
+void unbalanced(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    std::fill(res, res + n + m, uint32_t(0));
+    Arena::Mark mark = arena.mark();
+    uint32_t* part = arena.allocate<uint32_t>(2 * m);
+    for (size_t off = 0; off < n; off += m) {
+        size_t len = std::min(m, n - off);
+        multiplyRec(arena, a + off, len, b, m, part);
+        addInto(res + off, n + m - off, part, trim(part, len + m));
+    }
+    arena.release(mark);
+}
+
+// a = a0 + a1 * B^h, b = b0 + b1 * B^h,
+// a * b = a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) * B^h + a1 b1 * B^2h. n >= m > n / 2
+void karatsuba(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    size_t h = (n + 1) / 2;
+    multiplyRec(arena, a, h, b, h, res);
+    multiplyRec(arena, a + h, n - h, b + h, m - h, res + 2 * h);
+
+    Arena::Mark mark = arena.mark();
+    uint32_t* sa = arena.allocate<uint32_t>(h + 1);
+    uint32_t* sb = arena.allocate<uint32_t>(h + 1);
+    uint32_t* mid = arena.allocate<uint32_t>(2 * h + 2);
+    std::memcpy(sa, a, h * sizeof(uint32_t));
+    std::memcpy(sb, b, h * sizeof(uint32_t));
+    sa[h] = addInto(sa, h, a + h, n - h);
+    sb[h] = addInto(sb, h, b + h, m - h);
+    multiplyRec(arena, sa, h + 1, sb, h + 1, mid);
+    subInto(mid, 2 * h + 2, res, 2 * h);
+    subInto(mid, 2 * h + 2, res + 2 * h, n + m - 2 * h);
+    addInto(res + h, n + m - h, mid, trim(mid, 2 * h + 2));
+    arena.release(mark);
+}
+
+// Число со знаком поверх разрядов в арене или в операнде; n - длина без ведущих нулей
+struct Num {
+    const uint32_t* d;
+    size_t n;
+    bool neg;
+};
+
+Num view(const uint32_t* a, size_t begin, size_t end) {
+    if (begin >= end) return Num{a, 0, false};
+    return Num{a + begin, trim(a + begin, end - begin), false};
+}
+
+Num add(Arena& arena, Num x, Num y) {
+    if (x.n < y.n || (x.neg != y.neg && compare(x.d, x.n, y.d, y.n) < 0)) std::swap(x, y);
+    uint32_t* d = arena.allocate<uint32_t>(x.n + 1);
+    std::memcpy(d, x.d, x.n * sizeof(uint32_t));
+    if (x.neg == y.neg) {
+        d[x.n] = addInto(d, x.n, y.d, y.n);
+        return Num{d, trim(d, x.n + 1), x.neg};
+    }
+    subInto(d, x.n, y.d, y.n);
+    size_t n = trim(d, x.n);
+    return Num{d, n, n > 0 && x.neg};
+}
+
+Num sub(Arena& arena, Num x, Num y) {
+    y.neg = !y.neg && y.n > 0;
+    return add(arena, x, y);
+}
+
+Num multiply(Arena& arena, Num x, Num y) {
+    if (x.n == 0 || y.n == 0) return Num{x.d, 0, false};
+    uint32_t* d = arena.allocate<uint32_t>(x.n + y.n);
+    multiplyRec(arena, x.d, x.n, y.d, y.n, d);
+    return Num{d, trim(d, x.n + y.n), x.neg != y.neg};
+}
+
+// Точное деление на маленькое число, начиная со старшего разряда
+Num divide(Arena& arena, Num x, uint32_t k) {
+    uint32_t* d = arena.allocate<uint32_t>(x.n);
+    uint64_t rem = 0;
+    for (size_t i = x.n; i > 0; --i) {
+        uint64_t cur = rem * BASE + x.d[i - 1];
+        d[i - 1] = static_cast<uint32_t>(cur / k);
+        rem = cur % k;
+    }
+    size_t n = trim(d, x.n);
+    return Num{d, n, n > 0 && x.neg};
+}
+
+// Значения многочлена a0 + a1 t + a2 t^2 в точках 1, -1, -2
+struct Points {
+    Num p1;
+    Num m1;
+    Num m2;
+};
+
+Points evaluate(Arena& arena, Num x0, Num x1, Num x2) {
+    Num even = add(arena, x0, x2);
+    Num twice = add(arena, x2, x2);
+    twice = sub(arena, twice, x1);
+    twice = add(arena, twice, twice);
+    return Points{add(arena, even, x1), sub(arena, even, x1), add(arena, twice, x0)};
+}
+
+// Тоом-3: операнды режутся на три части по k разрядов, произведение восстанавливается по значениям
+// в точках 0, 1, -1, -2, бесконечность последовательностью интерполяции Бодрато. n >= m > n / 2
+void toom3(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    size_t k = (n + 2) / 3;
+    Arena::Mark mark = arena.mark();
+
+    Num a0 = view(a, 0, k), a1 = view(a, k, 2 * k), a2 = view(a, 2 * k, n);
+    Num b0 = view(b, 0, std::min(k, m)), b1 = view(b, k, std::min(2 * k, m)), b2 = view(b, 2 * k, m);
+    Points pa = evaluate(arena, a0, a1, a2);
+    Points pb = evaluate(arena, b0, b1, b2);
+
+    Num r0 = multiply(arena, a0, b0);
+    Num r1 = multiply(arena, pa.p1, pb.p1);
+    Num rm1 = multiply(arena, pa.m1, pb.m1);
+    Num rm2 = multiply(arena, pa.m2, pb.m2);
+    Num rinf = multiply(arena, a2, b2);
+
+    Num c3 = divide(arena, sub(arena, rm2, r1), 3);
+    Num c1 = divide(arena, sub(arena, r1, rm1), 2);
+    Num c2 = sub(arena, rm1, r0);
+    c3 = add(arena, divide(arena, sub(arena, c2, c3), 2), add(arena, rinf, rinf));
+    c2 = sub(arena, add(arena, c2, c1), rinf);
+    c1 = sub(arena, c1, c3);
+
+    std::fill(res, res + n + m, uint32_t(0));
+    const Num coeffs[] = {r0, c1, c2, c3, rinf};
+    for (size_t i = 0; i < 5; ++i)
+        if (coeffs[i].n > 0) addInto(res + i * k, n + m - i * k, coeffs[i].d, coeffs[i].n);
+    arena.release(mark);
+}
+
+// Простые вида c * 2^k + 1 меньше 2^31 и их первообразные корни. Коэффициент свёртки не больше
+// min(n, m) * (10^9 - 1)^2, а произведение трёх простых около 1.7 * 10^27, так что по китайской
+// теореме об остатках свёртка восстанавливается точно
+struct Prime {
+    uint32_t p;
+    uint32_t g;
+};
+
+constexpr Prime kPrimes[3] = {{2013265921, 31}, {469762049, 3}, {1811939329, 13}};
+
+constexpr uint32_t powMod(uint64_t a, uint64_t e, uint32_t p) {
+    uint64_t res = 1;
+    for (a %= p; e > 0; e >>= 1, a = a * a % p)
+        if (e & 1) res = res * a % p;
+    return static_cast<uint32_t>(res);
+}
+
+// Умножение по Монтгомери: mul(a, b) = a * b * 2^-32 mod p без деления
+class Montgomery {
+public:
+    explicit Montgomery(uint32_t p) : _p(p), _r2(static_cast<uint32_t>((uint64_t(1) << 32) % p)) {
+        uint32_t inv = p;
+        for (int i = 0; i < 5; ++i) inv *= 2 - p * inv;
+        _neg_inv = -inv;
+        _r2 = static_cast<uint32_t>(uint64_t(_r2) * _r2 % p);
+    }
+
+    uint32_t mul(uint32_t a, uint32_t b) const {
+        uint64_t x = uint64_t(a) * b;
+        uint32_t q = static_cast<uint32_t>(x) * _neg_inv;
+        uint32_t t = static_cast<uint32_t>((x + uint64_t(q) * _p) >> 32);
+        return t >= _p ? t - _p : t;
+    }
+
+    uint32_t add(uint32_t a, uint32_t b) const {
+        uint32_t s = a + b;
+        return s >= _p ? s - _p : s;
+    }
+
+    uint32_t sub(uint32_t a, uint32_t b) const { return a >= b ? a - b : a + _p - b; }
+
+    uint32_t toMont(uint32_t a) const { return mul(a, _r2); }
+
+private:
+    uint32_t _p;
+    uint32_t _neg_inv;
+    uint32_t _r2;
+};
+
+// roots[len + j] = w^j в форме Монтгомери, где w - первообразный корень степени 2 * len из root
+void buildRoots(const Montgomery& mont, uint32_t p, uint32_t root, size_t size, uint32_t* roots) {
+    for (size_t len = 1; len < size; len *= 2) {
+        uint32_t w = mont.toMont(powMod(root, (p - 1) / (2 * len), p));
+        roots[len] = mont.toMont(1);
+        for (size_t j = 1; j < len; ++j) roots[len + j] = mont.mul(roots[len + j - 1], w);
+    }
+}
+
+// Прямое преобразование с прореживанием по частоте оставляет результат в бит-реверсном порядке,
+// обратное с прореживанием по времени принимает его как есть, поэтому перестановка не нужна
+void forward(const Montgomery& mont, uint32_t* a, size_t size, const uint32_t* roots) {
+    for (size_t len = size / 2; len >= 1; len /= 2)
+        for (size_t i = 0; i < size; i += 2 * len)
+            for (size_t j = 0; j < len; ++j) {
+                uint32_t u = a[i + j];
+                uint32_t v = a[i + j + len];
+                a[i + j] = mont.add(u, v);
+                a[i + j + len] = mont.mul(mont.sub(u, v), roots[len + j]);
+            }
+}
+
+void inverse(const Montgomery& mont, uint32_t* a, size_t size, const uint32_t* roots) {
+    for (size_t len = 1; len < size; len *= 2)
+        for (size_t i = 0; i < size; i += 2 * len)
+            for (size_t j = 0; j < len; ++j) {
+                uint32_t u = a[i + j];
+                uint32_t v = mont.mul(a[i + j + len], roots[len + j]);
+                a[i + j] = mont.add(u, v);
+                a[i + j + len] = mont.sub(u, v);
+            }
+}
+
+void reduce(const uint32_t* a, size_t n, uint32_t p, size_t size, uint32_t* dst) {
+    for (size_t i = 0; i < n; ++i) dst[i] = a[i] % p;
+    std::fill(dst + n, dst + size, uint32_t(0));
+}
+
+// dst = свёртка a и b по модулю prime.p. Входы не переводятся в форму Монтгомери: умножение на корни
+// в этой форме сохраняет обычные значения, а лишний множитель 2^-32 от поэлементного произведения
+// снимается вместе с делением на size
+void convolve(const uint32_t* a, size_t n, const uint32_t* b, size_t m, size_t size, const Prime& prime,
+              uint32_t* dst, uint32_t* fb, uint32_t* roots, uint32_t* iroots) {
+    const uint32_t p = prime.p;
+    Montgomery mont(p);
+    buildRoots(mont, p, prime.g, size, roots);
+    buildRoots(mont, p, powMod(prime.g, p - 2, p), size, iroots);
+
+    reduce(a, n, p, size, dst);
+    forward(mont, dst, size, roots);
+    if (a == b && n == m) {
+        for (size_t i = 0; i < size; ++i) dst[i] = mont.mul(dst[i], dst[i]);
+    } else {
+        reduce(b, m, p, size, fb);
+        forward(mont, fb, size, roots);
+        for (size_t i = 0; i < size; ++i) dst[i] = mont.mul(dst[i], fb[i]);
+    }
+    inverse(mont, dst, size, iroots);
+
+    uint32_t scale = mont.toMont(mont.toMont(powMod(size, p - 2, p)));
+    for (size_t i = 0; i < size; ++i) dst[i] = mont.mul(dst[i], scale);
+}
+
+// Восстанавливает коэффициенты свёртки по остаткам (алгоритм Гарнера) и сразу переносит их
+// в разряды по основанию 10^9: x = t1 + t2 * p1 + t3 * p1 * p2, где p1 * p2 < 10^18 занимает два разряда
+void recombine(const uint32_t* r1, const uint32_t* r2, const uint32_t* r3, size_t count, uint32_t* res) {
+    constexpr uint64_t p1 = kPrimes[0].p, p2 = kPrimes[1].p, p3 = kPrimes[2].p;
+    constexpr uint64_t inv1 = powMod(p1, p2 - 2, p2);
+    constexpr uint64_t inv12 = powMod(p1 * p2 % p3, p3 - 2, p3);
+    constexpr uint64_t q0 = p1 * p2 % BASE, q1 = p1 * p2 / BASE;
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i + 1 < count; ++i) {
+        uint64_t t1 = r1[i];
+        uint64_t t2 = (r2[i] + p2 - t1 % p2) * inv1 % p2;
+        uint64_t low = t1 + t2 * p1;
+        uint64_t t3 = (r3[i] + p3 - low % p3) * inv12 % p3;
+        uint64_t cur = low % BASE + t3 * q0 + carry;
+        res[i] = static_cast<uint32_t>(cur % BASE);
+        carry = cur / BASE + low / BASE + t3 * q1;
+    }
+    res[count - 1] = static_cast<uint32_t>(carry);
+}
+
+void multiplyRec(Arena& arena, const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m == 0) std::fill(res, res + n, uint32_t(0));
+    else if (m < KARATSUBA_THRESHOLD) schoolbook(arena, a, n, b, m, res);
+    else if (2 * m <= n) unbalanced(arena, a, n, b, m, res);
+    else if (m < TOOM3_THRESHOLD) karatsuba(arena, a, n, b, m, res);
+    else toom3(arena, a, n, b, m, res);
+}
+
+}
+
+void multiply(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    if (std::min(n, m) >= NTT_THRESHOLD && n + m <= NTT_MAX_SIZE) multiplyNtt(a, n, b, m, res);
+    else multiplyClassic(a, n, b, m, res);
+}
+
+void multiplyClassic(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    // Промежуточные значения всех уровней рекурсии занимают O(n + m) разрядов
+    Arena arena(8 * (n + m) * sizeof(uint64_t) + 4096);
+    multiplyRec(arena, a, n, b, m, res);
+}
+
+void multiplyNtt(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res) {
+    if (n + m > NTT_MAX_SIZE) throw std::length_error("Operands are too long for NTT multiplication");
+    if (n == 0 || m == 0) {
+        std::fill(res, res + n + m, uint32_t(0));
+        return;
+    }
+    size_t size = 1;
+    while (size < n + m - 1) size *= 2;
+
+    Arena arena(6 * size * sizeof(uint32_t) + 4096);
+    uint32_t* fb = arena.allocate<uint32_t>(size);
+    uint32_t* roots = arena.allocate<uint32_t>(size);
+    uint32_t* iroots = arena.allocate<uint32_t>(size);
+    uint32_t* conv[3];
+    for (size_t k = 0; k < 3; ++k) {
+        conv[k] = arena.allocate<uint32_t>(size);
+        convolve(a, n, b, m, size, kPrimes[k], conv[k], fb, roots, iroots);
+    }
+    recombine(conv[0], conv[1], conv[2], n + m, res);
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef BIGINT_MUL_H
+#define BIGINT_MUL_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Умножение модулей больших чисел в системе с основанием 10^9, младшие разряды первыми
+namespace bigint_mul {
+
+constexpr uint32_t BASE = 1000000000;
+
+// Ниже этой длины меньшего операнда (в разрядах) используется умножение столбиком,
+// ниже TOOM3_THRESHOLD - Карацуба, выше - Тоом-3
+constexpr size_t KARATSUBA_THRESHOLD = 48;
+constexpr size_t TOOM3_THRESHOLD = 256;
+// Начиная с этой длины меньшего операнда умножение идёт через NTT по трём простым модулям.
+// Длина преобразования ограничена степенью двойки в p - 1 самого неудобного модуля
+constexpr size_t NTT_THRESHOLD = 5000;
+constexpr size_t NTT_MAX_SIZE = size_t(1) << 26;
+
+// res[0 .. n + m) = a[0 .. n) * b[0 .. m); res не должен пересекаться с операндами.
+// Алгоритм выбирается по длинам операндов
+void multiply(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res);
+
+// Только столбик, Карацуба и Тоом-3
+void multiplyClassic(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res);
+
+// Только NTT; при n + m > NTT_MAX_SIZE бросает std::length_error
+void multiplyNtt(const uint32_t* a, size_t n, const uint32_t* b, size_t m, uint32_t* res);
+
+}
+
+#endif
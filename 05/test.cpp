@@ -1,6 +1,12 @@
 #include "BigInt.h"
+#include "bigint_mul.h"
 #include <gtest/gtest.h>
 #include <stdexcept>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 
 TEST(BigIntTest, DefaultTest) {
     BigInt num;
@@ -90,6 +96,294 @@ TEST(BigIntTest, CopyAndMoveTest) {
     EXPECT_EQ(moved_assigned, BigInt("987654321"));
 }
 
+TEST(BigIntTest, CompoundAssignmentTest) {
+    BigInt a("999999999999999999");
+    a += 1;
+    EXPECT_EQ(a, BigInt("1000000000000000000"));
+    a -= BigInt("1000000000000000001");
+    EXPECT_EQ(a, BigInt(-1));
+    a -= BigInt(-5);
+    EXPECT_EQ(a, BigInt(4));
+    a += BigInt(-10);
+    EXPECT_EQ(a, BigInt(-6));
+    a *= BigInt("-1000000000");
+    EXPECT_EQ(a, BigInt("6000000000"));
+    a *= BigInt(0);
+    EXPECT_EQ(a, BigInt(0));
+    EXPECT_FALSE(a < BigInt(0));
+
+    BigInt b("123456789123456789");
+    b += b;
+    EXPECT_EQ(b, BigInt("246913578246913578"));
+    b *= b;
+    EXPECT_EQ(b, BigInt("60966315122694714062490483000762084"));
+    b -= b;
+    EXPECT_EQ(b, BigInt(0));
+
+    BigInt sum;
+    BigInt term("987654321987654321");
+    for (int i = 0; i < 1000; ++i) sum += term;
+    EXPECT_EQ(sum, term * 1000);
+    for (int i = 0; i < 1000; ++i) sum -= term;
+    EXPECT_EQ(sum, BigInt(0));
+}
+
+TEST(BigIntTest, MultiplyAssignTest) {
+    // Размеры по обе стороны порогов Карацубы, Тоом-3 и NTT; и с запасом памяти, и с ростом
+    for (size_t digits : {5, 40, 500, 3000, 50000}) {
+        BigInt a("-" + std::string(digits, '7'));
+        BigInt b(std::string(digits / 2 + 1, '3'));
+        BigInt expected = a * b;
+
+        BigInt grown = a;
+        grown *= b;
+        EXPECT_EQ(grown, expected);
+
+        BigInt roomy(std::string(3 * digits, '1'));
+        roomy -= BigInt(std::string(3 * digits, '1'));
+        roomy += a;
+        roomy *= b;
+        EXPECT_EQ(roomy, expected);
+
+        roomy *= roomy;
+        EXPECT_EQ(roomy, expected * expected);
+        roomy *= BigInt(0);
+        EXPECT_EQ(roomy, BigInt(0));
+        EXPECT_FALSE(roomy.is_negative());
+    }
+
+    BigInt inline_value(-12345);
+    inline_value *= BigInt(-6789);
+    EXPECT_EQ(inline_value, BigInt(83810205));
+}
+
+TEST(BigIntTest, RvalueOperatorsTest) {
+    BigInt a("123456789012345678901234567890");
+    BigInt b("-98765432109876543210");
+    BigInt sum = a + b;
+    BigInt diff = a - b;
+
+    EXPECT_EQ(BigInt(a) + b, sum);
+    EXPECT_EQ(a + BigInt(b), sum);
+    EXPECT_EQ(BigInt(a) + BigInt(b), sum);
+    EXPECT_EQ(BigInt(a) - b, diff);
+    EXPECT_EQ(a - BigInt(b), diff);
+    EXPECT_EQ(b - BigInt(a), -diff);
+    EXPECT_EQ(BigInt(a) - BigInt(b), diff);
+    EXPECT_EQ(-BigInt(a), BigInt("-123456789012345678901234567890"));
+    EXPECT_EQ(a - BigInt(a), BigInt(0));
+    EXPECT_FALSE(a - BigInt(a) < BigInt(0));
+
+    // Аккумулятор передаётся во временный операнд и возвращается обратно
+    BigInt acc;
+    for (int i = 0; i < 100; ++i) acc = std::move(acc) + a;
+    EXPECT_EQ(acc, a * 100);
+    for (int i = 0; i < 100; ++i) acc = std::move(acc) - a;
+    EXPECT_EQ(acc, BigInt(0));
+}
+
+TEST(BigIntTest, StorageTest) {
+    // Переходы между встроенными разрядами и кучей в обе стороны
+    BigInt small(42);
+    BigInt large(std::string(100, '7'));
+    BigInt moved_small(std::move(small));
+    BigInt moved_large(std::move(large));
+    EXPECT_EQ(moved_small, BigInt(42));
+    EXPECT_EQ(moved_large, BigInt(std::string(100, '7')));
+    EXPECT_EQ(small, BigInt(0));
+    EXPECT_EQ(large, BigInt(0));
+    EXPECT_EQ(small + 1, BigInt(1));
+
+    moved_large = std::move(moved_small);
+    EXPECT_EQ(moved_large, BigInt(42));
+    moved_small = BigInt(std::string(50, '3'));
+    EXPECT_EQ(moved_small, BigInt(std::string(50, '3')));
+    moved_small = BigInt(-8);
+    EXPECT_EQ(moved_small, BigInt(-8));
+
+    BigInt x("999999999999999999999999999999999999");
+    BigInt copy = x;
+    x += 1;
+    EXPECT_EQ(x, BigInt("1" + std::string(36, '0')));
+    x -= 1;
+    EXPECT_EQ(x, copy);
+    x -= copy;
+    EXPECT_EQ(x, BigInt(0));
+    x = copy;
+    EXPECT_EQ(x, copy);
+
+    BigInt grow(1);
+    for (int i = 0; i < 200; ++i) grow *= BigInt(1000);
+    EXPECT_EQ(grow, BigInt("1" + std::string(600, '0')));
+    grow = BigInt(5);
+    EXPECT_EQ(grow + grow, BigInt(10));
+}
+
+TEST(BigIntTest, SignTest) {
+    EXPECT_TRUE(BigInt().is_zero());
+    EXPECT_TRUE(BigInt("-0").is_zero());
+    EXPECT_FALSE(BigInt("-0").is_negative());
+    EXPECT_TRUE(BigInt(-3).is_negative());
+    EXPECT_FALSE(BigInt(-3).is_positive());
+    EXPECT_TRUE(BigInt("1000000000000").is_positive());
+    EXPECT_TRUE((BigInt(7) - BigInt(7)).is_zero());
+    EXPECT_FALSE((BigInt(7) - BigInt(7)).is_negative());
+    EXPECT_TRUE((-BigInt(0)).is_zero());
+    EXPECT_FALSE((-BigInt(0)).is_negative());
+}
+
+TEST(BigIntTest, MixedIntegerTest) {
+    const int64_t min64 = std::numeric_limits<int64_t>::min();
+    const int64_t max64 = std::numeric_limits<int64_t>::max();
+    const uint64_t umax64 = std::numeric_limits<uint64_t>::max();
+
+    EXPECT_EQ(BigInt(min64), BigInt("-9223372036854775808"));
+    EXPECT_EQ(BigInt(max64), BigInt("9223372036854775807"));
+    EXPECT_EQ(BigInt(umax64), BigInt("18446744073709551615"));
+    EXPECT_EQ(BigInt(static_cast<short>(-12)), BigInt(-12));
+    EXPECT_EQ(BigInt(42u), BigInt(42));
+    EXPECT_EQ(BigInt(42ll), BigInt(42ull));
+
+    BigInt a("123456789012345678901234567890");
+    EXPECT_EQ(a + min64, a + BigInt(min64));
+    EXPECT_EQ(a - min64, a - BigInt(min64));
+    EXPECT_EQ(a + umax64, a + BigInt(umax64));
+    EXPECT_EQ(a - umax64, a - BigInt(umax64));
+    EXPECT_EQ(a * min64, a * BigInt(min64));
+    EXPECT_EQ(a * umax64, a * BigInt(umax64));
+    EXPECT_EQ(a * 0, BigInt(0));
+    EXPECT_FALSE((-a * 0).is_negative());
+    EXPECT_EQ(BigInt(a) * -1, -a);
+
+    BigInt b(5);
+    b -= 7u;
+    EXPECT_EQ(b, -2);
+    b += max64;
+    EXPECT_EQ(b, max64 - 2);
+    b *= umax64;
+    EXPECT_EQ(b, BigInt(max64 - 2) * BigInt(umax64));
+    b -= b;
+    EXPECT_TRUE(b.is_zero());
+    b -= 0;
+    EXPECT_TRUE(b.is_zero());
+    EXPECT_FALSE(b.is_negative());
+
+    EXPECT_TRUE(BigInt(umax64) > max64);
+    EXPECT_TRUE(BigInt(min64) < -max64);
+    EXPECT_TRUE(BigInt(-1) < 0u);
+    EXPECT_TRUE(BigInt(min64) == min64);
+    EXPECT_TRUE(BigInt(umax64) != max64);
+    EXPECT_TRUE(a > umax64);
+    EXPECT_TRUE(-a < min64);
+    EXPECT_TRUE(0 == BigInt());
+    EXPECT_TRUE(5 < BigInt(6));
+    EXPECT_TRUE(umax64 >= BigInt(umax64));
+}
+
+template<class T>
+concept MixesWithBigInt = requires(BigInt a, T v) {
+    BigInt(v);
+    a + v;
+    a - v;
+    a * v;
+    a += v;
+    a < v;
+    v == a;
+};
+
+TEST(BigIntTest, MixedTypeConstraintTest) {
+    static_assert(MixesWithBigInt<int>);
+    static_assert(MixesWithBigInt<short>);
+    static_assert(MixesWithBigInt<unsigned long long>);
+    static_assert(MixesWithBigInt<int8_t> == !std::is_same_v<int8_t, signed char>);
+
+    static_assert(!MixesWithBigInt<bool>);
+    static_assert(!MixesWithBigInt<char>);
+    static_assert(!MixesWithBigInt<signed char>);
+    static_assert(!MixesWithBigInt<unsigned char>);
+    static_assert(!MixesWithBigInt<wchar_t>);
+    static_assert(!MixesWithBigInt<char8_t>);
+    static_assert(!MixesWithBigInt<char16_t>);
+    static_assert(!MixesWithBigInt<char32_t>);
+
+    EXPECT_EQ(BigInt(7) + static_cast<short>(-2), BigInt(5));
+}
+
+static std::string ToString(const BigInt& num) {
+    std::ostringstream os;
+    os << num;
+    return os.str();
+}
+
+TEST(BigIntTest, LimbBoundaryTest) {
+    EXPECT_EQ(ToString(BigInt("999999999") + 1), "1000000000");
+    EXPECT_EQ(ToString(BigInt("1000000000") - 1), "999999999");
+    EXPECT_EQ(ToString(BigInt("1000000000000000001")), "1000000000000000001");
+    EXPECT_EQ(ToString(BigInt("-000000000000000000042")), "-42");
+    EXPECT_EQ(ToString(BigInt(INT32_MIN)), "-2147483648");
+    EXPECT_EQ(ToString(BigInt("999999999999999999") * BigInt("999999999999999999")),
+              "999999999999999998000000000000000001");
+    EXPECT_EQ(BigInt("1000000000000000000000000000") - BigInt("1"), BigInt("999999999999999999999999999"));
+    EXPECT_THROW(BigInt("1234567890123x"), std::invalid_argument);
+}
+
+TEST(BigIntTest, LargeNumbersTest) {
+    // (10^n - 1)^2 = 10^2n - 2 * 10^n + 1 = 9...98 0...01
+    const size_t n = 10000;
+    BigInt nines(std::string(n, '9'));
+    std::string expected = std::string(n - 1, '9') + "8" + std::string(n - 1, '0') + "1";
+    EXPECT_EQ(ToString(nines * nines), expected);
+    EXPECT_EQ(ToString(nines + 1), "1" + std::string(n, '0'));
+    EXPECT_EQ(nines * nines - nines * nines, BigInt(0));
+    EXPECT_EQ(ToString(-nines * nines), "-" + expected);
+}
+
+static BigInt RandomBigInt(std::mt19937_64& rng, size_t digits) {
+    std::string str(digits, '0');
+    for (char& c : str) c = static_cast<char>('0' + rng() % 10);
+    str[0] = static_cast<char>('1' + rng() % 9);
+    return BigInt(str);
+}
+
+TEST(BigIntTest, FastMultiplicationTest) {
+    // Размеры пересекают пороги Карацубы и Тоом-3, в том числе для операндов разной длины
+    std::mt19937_64 rng(42);
+    for (size_t digits : {300, 450, 2000, 2400, 9000, 30000}) {
+        BigInt a = RandomBigInt(rng, digits);
+        BigInt b = RandomBigInt(rng, digits - digits / 3);
+        BigInt c = RandomBigInt(rng, digits / 7 + 1);
+        EXPECT_EQ((a + b) * (a - b), a * a - b * b) << digits;
+        EXPECT_EQ((a * b) * c, a * (b * c)) << digits;
+        EXPECT_EQ(a * (b + c), a * b + a * c) << digits;
+        EXPECT_EQ(-a * b, a * -b) << digits;
+    }
+}
+
+TEST(BigIntTest, NttMultiplicationTest) {
+    // Разряды 10^9 - 1 дают наибольшие коэффициенты свёртки
+    std::mt19937_64 rng(7);
+    for (auto [n, m] : {std::pair<size_t, size_t>{1, 1}, {3, 1000}, {777, 777}, {5000, 4097}, {9000, 9000}}) {
+        for (bool max_limbs : {false, true}) {
+            std::vector<uint32_t> a(n), b(m);
+            for (uint32_t& x : a) x = max_limbs ? bigint_mul::BASE - 1 : static_cast<uint32_t>(rng() % bigint_mul::BASE);
+            for (uint32_t& x : b) x = max_limbs ? bigint_mul::BASE - 1 : static_cast<uint32_t>(rng() % bigint_mul::BASE);
+            std::vector<uint32_t> expected(n + m), actual(n + m);
+            bigint_mul::multiplyClassic(a.data(), n, b.data(), m, expected.data());
+            bigint_mul::multiplyNtt(a.data(), n, b.data(), m, actual.data());
+            EXPECT_EQ(actual, expected) << n << " x " << m;
+
+            std::vector<uint32_t> square(2 * n), expected_square(2 * n);
+            bigint_mul::multiplyClassic(a.data(), n, a.data(), n, expected_square.data());
+            bigint_mul::multiplyNtt(a.data(), n, a.data(), n, square.data());
+            EXPECT_EQ(square, expected_square) << n;
+        }
+    }
+
+    BigInt x = RandomBigInt(rng, 60000);
+    BigInt y = RandomBigInt(rng, 50000);
+    EXPECT_EQ((x + y) * (x - y), x * x - y * y);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();